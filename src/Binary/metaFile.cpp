@@ -1,5 +1,7 @@
 #include "metaFile.h"
-#include "Utils/fileStream.h"
+#include "Utils/OutputFile.h"
+#include "Utils/memoryStream.h"
+#include <stdexcept>
 
 unsigned int binary::MetaFile::size()
 {
@@ -47,9 +49,13 @@ binary::BinaryReader binary::MetaFile::heap_reader()
 
 void binary::MetaFile::save(string filename)
 {
-    std::shared_ptr<utils::FileStream> fileStream = utils::FileStream::open(filename, ios::out | ios::binary | ios::trunc);
-    this->save(fileStream);
-    fileStream->close();
+    // Serialized in memory first, so that an unchanged file is not rewritten
+    std::shared_ptr<utils::MemoryStream> memoryStream = std::shared_ptr<utils::MemoryStream>(new utils::MemoryStream());
+    this->save(memoryStream);
+    std::string content(memoryStream->begin(), memoryStream->end());
+    if (std::error_code error = utils::OutputFile::write(filename, content)) {
+        throw std::runtime_error("Unable to write " + filename + ": " + error.message());
+    }
 }
 
 void binary::MetaFile::save(std::shared_ptr<utils::Stream> stream)
@@ -0,0 +1,77 @@
+#include "ClassHierarchy.h"
+#include <cassert>
+
+namespace Meta {
+ClassHierarchy::ClassHierarchy(const MetaContainer& container)
+{
+    std::unordered_set<BaseClassMeta*> visited;
+    for (MetaType type : { MetaType::Protocol, MetaType::Interface }) {
+        for (Meta* meta : container.ofType(type)) {
+            addToTopologicalOrder(&meta->as<BaseClassMeta>(), visited);
+        }
+    }
+
+    // Everything a class refers to precedes it, so the parents' results are always available
+    for (BaseClassMeta* meta : _topologicalOrder) {
+        if (meta->is(MetaType::Protocol)) {
+            ProtocolMeta* protocol = &meta->as<ProtocolMeta>();
+            std::vector<BaseClassMeta*>& closure = _protocolClosures[protocol];
+            std::unordered_set<BaseClassMeta*> added;
+            appendUnique(closure, { protocol }, added);
+            for (ProtocolMeta* adoptedProtocol : protocol->protocols) {
+                appendUnique(closure, _protocolClosures[adoptedProtocol], added);
+            }
+        } else if (meta->is(MetaType::Interface)) {
+            InterfaceMeta* interface = &meta->as<InterfaceMeta>();
+            std::vector<BaseClassMeta*>& inheritedClasses = _inheritedClasses[interface];
+            if (InterfaceMeta* base = interface->base) {
+                std::unordered_set<BaseClassMeta*> added;
+                appendUnique(inheritedClasses, { base }, added);
+                for (ProtocolMeta* protocol : base->protocols) {
+                    appendUnique(inheritedClasses, _protocolClosures[protocol], added);
+                }
+                appendUnique(inheritedClasses, _inheritedClasses[base], added);
+            }
+        }
+    }
+}
+
+std::vector<BaseClassMeta*> ClassHierarchy::getParents(BaseClassMeta* meta)
+{
+    std::vector<BaseClassMeta*> parents;
+    if (meta->is(MetaType::Interface)) {
+        if (InterfaceMeta* base = meta->as<InterfaceMeta>().base) {
+            parents.push_back(base);
+        }
+    }
+    parents.insert(parents.end(), meta->protocols.begin(), meta->protocols.end());
+    return parents;
+}
+
+const std::vector<BaseClassMeta*>& ClassHierarchy::getInheritedClasses(InterfaceMeta* interface) const
+{
+    std::unordered_map<InterfaceMeta*, std::vector<BaseClassMeta*> >::const_iterator it = _inheritedClasses.find(interface);
+    assert(it != _inheritedClasses.end());
+    return it->second;
+}
+
+void ClassHierarchy::addToTopologicalOrder(BaseClassMeta* meta, std::unordered_set<BaseClassMeta*>& visited)
+{
+    if (!visited.insert(meta).second) {
+        return;
+    }
+    for (BaseClassMeta* parent : getParents(meta)) {
+        addToTopologicalOrder(parent, visited);
+    }
+    _topologicalOrder.push_back(meta);
+}
+
+void ClassHierarchy::appendUnique(std::vector<BaseClassMeta*>& to, const std::vector<BaseClassMeta*>& classes, std::unordered_set<BaseClassMeta*>& added)
+{
+    for (BaseClassMeta* meta : classes) {
+        if (added.insert(meta).second) {
+            to.push_back(meta);
+        }
+    }
+}
+}
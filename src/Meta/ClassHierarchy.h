@@ -0,0 +1,44 @@
+#pragma once
+#include "MetaContainer.h"
+#include "MetaEntities.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Meta {
+/*
+ * \class ClassHierarchy
+ * \brief Orders the interfaces and protocols so that each of them comes after its base class and
+ * protocols, and linearizes the classes each interface inherits its members from.
+ *
+ * The hierarchy includes the classes which are only reachable from the metas in the container.
+ * Member-level passes walk it once in topological order instead of recursing up the hierarchy
+ * for every class. The members themselves are read by the passes, since they change between them.
+ */
+class ClassHierarchy {
+public:
+    explicit ClassHierarchy(const MetaContainer& container);
+
+    const std::vector<BaseClassMeta*>& getTopologicalOrder() const
+    {
+        return _topologicalOrder;
+    }
+
+    // The base class and the protocols of a class (in this order)
+    static std::vector<BaseClassMeta*> getParents(BaseClassMeta* meta);
+
+    // The classes an interface inherits members from, in lookup order: its base class, the protocols
+    // of the base class (depth first), the base class of the base class and so on. Each class is listed once.
+    const std::vector<BaseClassMeta*>& getInheritedClasses(InterfaceMeta* interface) const;
+
+private:
+    void addToTopologicalOrder(BaseClassMeta* meta, std::unordered_set<BaseClassMeta*>& visited);
+
+    static void appendUnique(std::vector<BaseClassMeta*>& to, const std::vector<BaseClassMeta*>& classes, std::unordered_set<BaseClassMeta*>& added);
+
+    std::vector<BaseClassMeta*> _topologicalOrder;
+    // The protocol itself followed by the protocols it adopts (depth first)
+    std::unordered_map<ProtocolMeta*, std::vector<BaseClassMeta*> > _protocolClosures;
+    std::unordered_map<InterfaceMeta*, std::vector<BaseClassMeta*> > _inheritedClasses;
+};
+}
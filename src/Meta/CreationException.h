@@ -4,43 +4,59 @@
 #pragma once
 #include "MetaEntities.h"
 #include "TypeEntities.h"
+#include <cassert>
 #include <clang/AST/Type.h>
+#include <llvm/Support/Casting.h>
+#include <llvm/Support/raw_ostream.h>
+#include <memory>
 #include <string>
+#include <type_traits>
 
-
-#define DEFINE_POLYMORPHIC_THROW \
-virtual void polymorhicThrow() override { \
-    throw *this; \
-}
-
-
-#define POLYMORPHIC_THROW(ex) do \
+// Returns the exception of a failed CreationResult from the enclosing function
+#define RETURN_IF_FAILED(result) do \
 { \
-    ex->polymorhicThrow(); \
-    throw std::logic_error("polymorphicThrow should never return"); \
+    if (!(result)) \
+        return (result).getException(); \
 } while(false)
 
 namespace Meta {
+/*
+ * \class CreationException
+ * \brief Describes why a meta or type could not be created.
+ *
+ * Creation exceptions are not thrown but passed around in \c CreationResult objects and shared between
+ * the factory caches. Their messages are composed only when somebody asks for them.
+ */
 class CreationException {
 public:
-    static std::string constructMessage(std::string outerMessage, std::string innerMessage)
+    enum class Kind {
+        Meta,
+        Type
+    };
+
+    CreationException(Kind kind, const char* message, bool isError, std::shared_ptr<CreationException> innerException)
+        : _kind(kind)
+        , _message(message)
+        , _isError(isError)
+        , _innerException(std::move(innerException))
     {
-        return outerMessage + " --> " + innerMessage;
     }
 
-    CreationException(std::string message, bool isError)
-        : _message(message)
-        , _isError(isError)
+    virtual ~CreationException() { }
+
+    Kind getKind() const
     {
+        return _kind;
     }
-    
-    virtual ~CreationException() { }
 
-    virtual void polymorhicThrow() = 0;
-    
     std::string getMessage() const
     {
-        return _message;
+        std::string message(_message);
+        std::string innerMessage = this->getInnerMessage();
+        if (!innerMessage.empty()) {
+            message += " --> " + innerMessage;
+        }
+        return message;
     }
 
     virtual std::string getDetailedMessage() const
@@ -53,16 +69,33 @@ public:
         return _isError;
     }
 
+protected:
+    virtual std::string getInnerMessage() const
+    {
+        return _innerException ? _innerException->getDetailedMessage() : std::string();
+    }
+
 private:
-    std::string _message;
+    Kind _kind;
+    const char* _message;
     bool _isError;
+    std::shared_ptr<CreationException> _innerException;
 };
 
 class MetaCreationException : public CreationException {
 public:
-    MetaCreationException(const Meta* meta, std::string message, bool isError)
-        : CreationException(message, isError)
+    MetaCreationException(const Meta* meta, const char* message, bool isError, std::shared_ptr<CreationException> innerException = nullptr)
+        : CreationException(Kind::Meta, message, isError, std::move(innerException))
+        , _meta(meta)
+        , _invalidDecl(nullptr)
+    {
+    }
+
+    // The dump of the declaration is included in the message
+    MetaCreationException(const Meta* meta, const clang::Decl* invalidDecl)
+        : CreationException(Kind::Meta, "Invalid decl.", true, nullptr)
         , _meta(meta)
+        , _invalidDecl(invalidDecl)
     {
     }
 
@@ -71,21 +104,38 @@ public:
         return _meta->identificationString() + " : " + this->getMessage();
     }
 
-    const Meta* getMeta()
+    const Meta* getMeta() const
     {
         return _meta;
     }
 
-    DEFINE_POLYMORPHIC_THROW;
+    static bool classof(const CreationException* exception)
+    {
+        return exception->getKind() == Kind::Meta;
+    }
+
+protected:
+    std::string getInnerMessage() const override
+    {
+        if (_invalidDecl == nullptr) {
+            return CreationException::getInnerMessage();
+        }
+
+        std::string declDump;
+        llvm::raw_string_ostream os(declDump);
+        _invalidDecl->dump(os);
+        return os.str();
+    }
 
 private:
     const Meta* _meta;
+    const clang::Decl* _invalidDecl;
 };
 
 class TypeCreationException : public CreationException {
 public:
-    TypeCreationException(const clang::Type* type, std::string message, bool isError)
-        : CreationException(message, isError)
+    TypeCreationException(const clang::Type* type, const char* message, bool isError, std::shared_ptr<CreationException> innerException = nullptr)
+        : CreationException(Kind::Type, message, isError, std::move(innerException))
         , _type(type)
     {
     }
@@ -95,14 +145,60 @@ public:
         return std::string("[Type ") + (_type == nullptr ? "" : _type->getTypeClassName()) + "] : " + this->getMessage();
     }
 
-    const clang::Type* getType()
+    const clang::Type* getType() const
     {
         return _type;
     }
 
-    DEFINE_POLYMORPHIC_THROW;
+    static bool classof(const CreationException* exception)
+    {
+        return exception->getKind() == Kind::Type;
+    }
 
 private:
     const clang::Type* _type;
 };
+
+/*
+ * \class CreationResult<T>
+ * \brief Holds either a successfully created value or the exception describing why its creation has failed.
+ */
+template <class T>
+class CreationResult {
+public:
+    template <class U, class = typename std::enable_if<std::is_convertible<U, T>::value>::type>
+    CreationResult(U&& value)
+        : _value(std::forward<U>(value))
+        , _exception(nullptr)
+    {
+    }
+
+    template <class E, class = typename std::enable_if<std::is_base_of<CreationException, E>::value>::type>
+    CreationResult(std::shared_ptr<E> exception)
+        : _value()
+        , _exception(std::move(exception))
+    {
+        assert(_exception != nullptr);
+    }
+
+    explicit operator bool() const
+    {
+        return _exception == nullptr;
+    }
+
+    T& getValue()
+    {
+        assert(_exception == nullptr);
+        return _value;
+    }
+
+    const std::shared_ptr<CreationException>& getException() const
+    {
+        return _exception;
+    }
+
+private:
+    T _value;
+    std::shared_ptr<CreationException> _exception;
+};
 }
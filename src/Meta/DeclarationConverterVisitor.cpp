@@ -3,6 +3,44 @@
 
 using namespace std;
 
+// Only declaration contexts which can (lexically) contain exported declarations are walked.
+// Function and method bodies, parameters and blocks are skipped entirely.
+static bool canContainExportedDecls(const clang::Decl* decl)
+{
+    return clang::isa<clang::LinkageSpecDecl>(decl) || clang::isa<clang::NamespaceDecl>(decl) || clang::isa<clang::TagDecl>(decl) || clang::isa<clang::ObjCContainerDecl>(decl);
+}
+
+void Meta::DeclarationConverterVisitor::traverseDeclarations(clang::DeclContext* context)
+{
+    for (clang::Decl* decl : context->decls()) {
+        if (decl->isImplicit()) {
+            continue;
+        }
+
+        if (clang::FunctionDecl* function = clang::dyn_cast<clang::FunctionDecl>(decl))
+            VisitFunctionDecl(function);
+        else if (clang::VarDecl* var = clang::dyn_cast<clang::VarDecl>(decl))
+            VisitVarDecl(var);
+        else if (clang::EnumDecl* enumDecl = clang::dyn_cast<clang::EnumDecl>(decl))
+            VisitEnumDecl(enumDecl);
+        else if (clang::EnumConstantDecl* enumConstant = clang::dyn_cast<clang::EnumConstantDecl>(decl))
+            VisitEnumConstantDecl(enumConstant);
+        else if (clang::RecordDecl* record = clang::dyn_cast<clang::RecordDecl>(decl))
+            VisitRecordDecl(record);
+        else if (clang::ObjCInterfaceDecl* interface = clang::dyn_cast<clang::ObjCInterfaceDecl>(decl))
+            VisitObjCInterfaceDecl(interface);
+        else if (clang::ObjCProtocolDecl* protocol = clang::dyn_cast<clang::ObjCProtocolDecl>(decl))
+            VisitObjCProtocolDecl(protocol);
+        else if (clang::ObjCCategoryDecl* category = clang::dyn_cast<clang::ObjCCategoryDecl>(decl))
+            VisitObjCCategoryDecl(category);
+
+        // Nested declarations follow their parent, in the same order as a pre-order AST traversal
+        if (canContainExportedDecls(decl)) {
+            this->traverseDeclarations(clang::cast<clang::DeclContext>(decl));
+        }
+    }
+}
+
 bool Meta::DeclarationConverterVisitor::VisitFunctionDecl(clang::FunctionDecl* function)
 {
     return Visit<clang::FunctionDecl>(function);
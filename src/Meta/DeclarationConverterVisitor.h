@@ -1,29 +1,39 @@
 #pragma once
 
 #include "CreationException.h"
+#include "MetaContainer.h"
 #include "MetaFactory.h"
 #include "Filters/ModulesBlacklist.h"
-#include <clang/AST/RecursiveASTVisitor.h>
+#include "Utils/Logger.h"
+#include <clang/AST/Decl.h>
+#include <clang/AST/DeclCXX.h>
+#include <clang/AST/DeclObjC.h>
 #include <clang/Frontend/ASTUnit.h>
 #include <clang/Lex/HeaderSearch.h>
 #include <clang/Lex/Preprocessor.h>
-#include <iostream>
-#include <sstream>
 
 namespace Meta {
-class DeclarationConverterVisitor : public clang::RecursiveASTVisitor<DeclarationConverterVisitor> {
+class DeclarationConverterVisitor {
 public:
-    explicit DeclarationConverterVisitor(clang::SourceManager& sourceManager, clang::HeaderSearch& headerSearch, bool verbose, ModulesBlacklist& modulesBlacklist)
+    explicit DeclarationConverterVisitor(clang::SourceManager& sourceManager, clang::HeaderSearch& headerSearch, ModulesBlacklist& modulesBlacklist)
         : _metaContainer()
         , _metaFactory(sourceManager, headerSearch)
-        , _verbose(verbose)
         , _modulesBlacklist(modulesBlacklist)
     {
     }
 
-    std::list<Meta*>& generateMetadata(clang::TranslationUnitDecl* translationUnit)
+    MetaContainer& generateMetadata(clang::TranslationUnitDecl* translationUnit)
     {
-        this->TraverseDecl(translationUnit);
+        this->traverseDeclarations(translationUnit);
+
+        // Settle the metas which still depend on the outcome of others, so that nothing is created again once the filters
+        // have started to change the metas. The ones which turn out invalid are taken out of the container
+        // (there are only a few of them, if any).
+        for (Meta* invalidMeta : _metaFactory.settlePendingMetas()) {
+            _metaContainer.remove_if(invalidMeta->type, [invalidMeta](Meta* meta) {
+                return meta == invalidMeta;
+            });
+        }
         return _metaContainer;
     }
 
@@ -32,7 +42,7 @@ public:
         return this->_metaFactory;
     }
 
-    // RecursiveASTVisitor methods
+    // Called for each declaration found by traverseDeclarations
     bool VisitFunctionDecl(clang::FunctionDecl* function);
 
     bool VisitVarDecl(clang::VarDecl* var);
@@ -50,91 +60,98 @@ public:
     bool VisitObjCCategoryDecl(clang::ObjCCategoryDecl* protocol);
 
 private:
+    void traverseDeclarations(clang::DeclContext* context);
+
     template <class T>
     bool Visit(T* decl)
     {
-        try {
-            // Remove from cache if present to have a chance to process any errors
-            // in dependant types which have been pending when it was cached the 1st time.
-            // If we have the following (inspired from Tcl_HashTable):
-            // struct HashTable;
-            //
-            // struct HashEntry {
-            //  HashTable*table;
-            //  union {
-            //  }
-            // }
-            //
-            // struct HashTable {
-            //  HashEntry **entries;
-            // }
-            // We do not support unions, so HashEntry is not included in the metadata.
-            // But before the cache purge we were leaving HashTable and it caused crashes
-            // if accessed at runtime.
-
-            Meta* meta = this->_metaFactory.create(*decl, /*resetCached*/ true);
-            std::string whitelistRule, blacklistRule;
-            // Never blacklist NSObject - it's special and always needed by both the {N} runtime and the MDG
-            if (meta->name != "NSObject" && meta->module && _modulesBlacklist.shouldBlacklist(meta->module->getFullModuleName(), meta->name.empty() ? meta->jsName : meta->name, /*r*/whitelistRule, /*r*/blacklistRule)) {
-                logSymbolAction("Blacklisted", meta, whitelistRule, blacklistRule);
-            } else {
-                _metaContainer.push_back(meta);
-                logSymbolAction("Included", meta, whitelistRule, blacklistRule);
-            }
-        } catch (MetaCreationException& e) {
-            if (e.isError()) {
-                log(std::stringstream() << "Exception " << e.getDetailedMessage());
+        // A meta which has been cached while some of its dependencies were still pending is created again
+        // by the factory, so that any errors in them which have been found later are not missed.
+        // If we have the following (inspired from Tcl_HashTable):
+        // struct HashTable;
+        //
+        // struct HashEntry {
+        //  HashTable*table;
+        //  union {
+        //  }
+        // }
+        //
+        // struct HashTable {
+        //  HashEntry **entries;
+        // }
+        // We do not support unions, so HashEntry is not included in the metadata.
+        // But before taking the pending dependencies into account we were leaving HashTable
+        // and it caused crashes if accessed at runtime.
+
+        CreationResult<Meta*> result = this->_metaFactory.create(*decl);
+        if (!result) {
+            const std::shared_ptr<CreationException>& exception = result.getException();
+            utils::Logger& logger = utils::Logger::get();
+            if (exception->isError() && logger.isEnabled(utils::LogLevel::Verbose)) {
+                logger.log(utils::LogLevel::Verbose, "Exception " + exception->getDetailedMessage());
             } else {
                   // Uncomment for maximum verbosity when debugging metadata generation issues
 //                auto namedDecl = clang::dyn_cast<clang::NamedDecl>(decl);
 //                auto name = namedDecl ? namedDecl->getNameAsString() : "<unknown>";
-//                log(std::stringstream() << "Skipping " << name << ": " << e.getMessage());
+//                logger.log(utils::LogLevel::Verbose, "Skipping " + name + ": " + exception->getMessage());
             }
+            return true;
+        }
+
+        Meta* meta = result.getValue();
+        std::string whitelistRule, blacklistRule;
+        // Never blacklist NSObject - it's special and always needed by both the {N} runtime and the MDG
+        if (meta->name != "NSObject" && meta->module && _modulesBlacklist.shouldBlacklist(meta->module, meta->name.empty() ? meta->jsName : meta->name, /*r*/whitelistRule, /*r*/blacklistRule)) {
+            logSymbolAction("Blacklisted", meta, whitelistRule, blacklistRule);
+        } else {
+            _metaContainer.push_back(meta);
+            logSymbolAction("Included", meta, whitelistRule, blacklistRule);
         }
         return true;
     }
 
     void logSymbolAction(const std::string& action, const Meta *meta, const std::string &whitelistRule, const std::string &blacklistRule) {
-        std::stringstream ss;
-        ss << action << " ";
-        
+        utils::Logger& logger = utils::Logger::get();
+        if (!logger.isEnabled(utils::LogLevel::Verbose)) {
+            return;
+        }
+
+        std::string moduleName = meta->module->getFullModuleName();
+        std::string message = action + " ";
         if (!meta->name.empty() && meta->name != meta->jsName) {
-            ss << meta->name << " (JS: " << meta->jsName << ")";
+            message += meta->name + " (JS: " + meta->jsName + ")";
         } else {
-            ss << meta->jsName;
+            message += meta->jsName;
         }
         
-        ss << " from " << meta->module->getFullModuleName();
+        message += " from " + moduleName;
 
         if (!whitelistRule.empty() || !blacklistRule.empty()) {
-            ss << " (";
+            message += " (";
             if (!whitelistRule.empty()) {
-                ss << "enabled by '" << whitelistRule << "'";
+                message += "enabled by '" + whitelistRule + "'";
                 if (!blacklistRule.empty()) {
-                    ss << ", ";
+                    message += ", ";
                 }
             }
             if (!blacklistRule.empty()) {
-                ss << "disabled by '" << blacklistRule << "'";
+                message += "disabled by '" + blacklistRule + "'";
             }
-            ss << ")";
-        }
-        log(ss);
-    }
-    
-    inline void log(const std::stringstream& s) {
-        this->log(s.str());
-    }
-    
-    inline void log(std::string str) {
-        if (this->_verbose) {
-            std::cerr << "verbose: " << str << std::endl;
+            message += ")";
         }
+
+        logger.log(utils::LogLevel::Verbose, std::move(message), utils::Logger::Fields{
+            { "action", action },
+            { "name", meta->name },
+            { "jsName", meta->jsName },
+            { "module", std::move(moduleName) },
+            { "enabledBy", whitelistRule },
+            { "disabledBy", blacklistRule }
+        });
     }
     
-    std::list<Meta*> _metaContainer;
+    MetaContainer _metaContainer;
     MetaFactory _metaFactory;
-    bool _verbose;
     ModulesBlacklist& _modulesBlacklist;
 };
 } // namespace Meta
@@ -0,0 +1,61 @@
+#include "FilterPipeline.h"
+#include "HandleExceptionalMetasFilter.h"
+#include "HandleMethodsAndPropertiesWithSameNameFilter.h"
+#include "MergeCategoriesFilter.h"
+#include "RemoveDuplicateMembersFilter.h"
+#include "ResolveGlobalNamesCollisionsFilter.h"
+#include "Utils/Logger.h"
+#include <chrono>
+
+namespace Meta {
+void FilterPipeline::add(const std::string& name, FilterFunction filter)
+{
+    _stages.push_back(Stage{ name, std::move(filter) });
+}
+
+double FilterPipeline::runStage(const Stage& stage, MetaContainer& container)
+{
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    stage.filter(container);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+void FilterPipeline::run(MetaContainer& container)
+{
+    std::vector<double> durations(_stages.size());
+    for (size_t i = 0; i < _stages.size(); i++) {
+        durations[i] = runStage(_stages[i], container);
+    }
+
+    utils::Logger& logger = utils::Logger::get();
+    if (logger.isEnabled(utils::LogLevel::Verbose)) {
+        for (size_t i = 0; i < _stages.size(); i++) {
+            std::string seconds = std::to_string(durations[i]);
+            logger.log(utils::LogLevel::Verbose, "Filter " + _stages[i].name + " took " + seconds + " sec", utils::Logger::Fields{ { "filter", _stages[i].name }, { "seconds", seconds } });
+        }
+    }
+}
+
+FilterPipeline FilterPipeline::createDefault(MetaFactory& metaFactory, const SymbolIndex& symbolIndex, ResolveGlobalNamesCollisionsFilter& globalNamesCollisionsFilter)
+{
+    FilterPipeline pipeline;
+    pipeline.add("HandleExceptionalMetas", [&symbolIndex](MetaContainer& container) {
+        HandleExceptionalMetasFilter(symbolIndex).filter(container);
+    });
+    pipeline.add("MergeCategories", [](MetaContainer& container) {
+        MergeCategoriesFilter().filter(container);
+    });
+    pipeline.add("RemoveDuplicateMembers", [](MetaContainer& container) {
+        RemoveDuplicateMembersFilter().filter(container);
+    });
+    // Creates property metas through the shared meta factory
+    pipeline.add("HandleMethodsAndPropertiesWithSameName", [&metaFactory](MetaContainer& container) {
+        HandleMethodsAndPropertiesWithSameNameFilter(metaFactory).filter(container);
+    });
+    // Renames metas of all kinds
+    pipeline.add("ResolveGlobalNamesCollisions", [&globalNamesCollisionsFilter](MetaContainer& container) {
+        globalNamesCollisionsFilter.filter(container);
+    });
+    return pipeline;
+}
+}
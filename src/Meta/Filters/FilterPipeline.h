@@ -0,0 +1,41 @@
+#pragma once
+#include "Meta/MetaContainer.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Meta {
+class MetaFactory;
+class ResolveGlobalNamesCollisionsFilter;
+class SymbolIndex;
+
+/*
+ * \class FilterPipeline
+ * \brief Runs the filters over the meta container in the order in which they have been added.
+ *
+ * The running time of each filter is reported in verbose mode.
+ */
+class FilterPipeline {
+public:
+    typedef std::function<void(MetaContainer&)> FilterFunction;
+
+    void add(const std::string& name, FilterFunction filter);
+
+    void run(MetaContainer& container);
+
+    // The filters which are applied to the converted metas before serialization.
+    // The symbol index is built once after conversion and shared by the filters.
+    // The collisions filter is passed in because its result is used afterwards.
+    static FilterPipeline createDefault(MetaFactory& metaFactory, const SymbolIndex& symbolIndex, ResolveGlobalNamesCollisionsFilter& globalNamesCollisionsFilter);
+
+private:
+    struct Stage {
+        std::string name;
+        FilterFunction filter;
+    };
+
+    static double runStage(const Stage& stage, MetaContainer& container);
+
+    std::vector<Stage> _stages;
+};
+}
@@ -1,9 +1,19 @@
 #pragma once
+#include "Meta/MetaContainer.h"
 #include "Meta/MetaEntities.h"
+#include "Meta/SymbolIndex.h"
 
 namespace Meta {
 class HandleExceptionalMetasFilter {
 public:
-    void filter(std::list<Meta*>& container);
+    HandleExceptionalMetasFilter(const SymbolIndex& symbolIndex)
+        : _symbolIndex(symbolIndex)
+    {
+    }
+
+    void filter(MetaContainer& container);
+
+private:
+    const SymbolIndex& _symbolIndex;
 };
-}
\ No newline at end of file
+}
@@ -1,11 +1,31 @@
 #include "HandleMethodsAndPropertiesWithSameNameFilter.h"
+#include "Utils/Logger.h"
 
 namespace Meta {
-typedef  std::unordered_map<std::string, std::vector<MethodMeta*>>  MethodsStructure;
+// Methods are grouped by JS name and number of arguments. The key refers to the JS name of the first
+// method in the group, which is never renamed.
+struct MethodKey {
+    const std::string* jsName;
+    size_t signatureSize;
+
+    bool operator==(const MethodKey& other) const
+    {
+        return signatureSize == other.signatureSize && *jsName == *other.jsName;
+    }
+};
+
+struct MethodKeyHash {
+    size_t operator()(const MethodKey& key) const
+    {
+        return std::hash<std::string>()(*key.jsName) * 31 + key.signatureSize;
+    }
+};
+
+typedef  std::unordered_map<MethodKey, std::vector<MethodMeta*>, MethodKeyHash>  MethodsStructure;
 
 bool addMeta(MethodMeta* meta, MethodsStructure* methods, bool forceIfNameCollision)
 {
-    std::pair<std::unordered_map<std::string, std::vector<MethodMeta*> >::iterator, bool> insertionResult = methods->emplace(meta->jsName + std::to_string(meta->signature.size()), std::vector<MethodMeta*>());
+    std::pair<MethodsStructure::iterator, bool> insertionResult = methods->emplace(MethodKey{ &meta->jsName, meta->signature.size() }, std::vector<MethodMeta*>());
     
     if (insertionResult.second || forceIfNameCollision) {
         std::vector<MethodMeta*>& metasWithSameJsName = insertionResult.first->second;
@@ -20,56 +40,77 @@ HandleMethodsAndPropertiesWithSameNameFilter::HandleMethodsAndPropertiesWithSame
 {
 }
 
-void HandleMethodsAndPropertiesWithSameNameFilter::filter(std::list<Meta*>& container)
+// Many interfaces share the same base classes and protocols, and walking their hierarchies
+// (including categories) is expensive, so each lookup is performed only once
+template <class TContainerDecl>
+clang::ObjCMethodDecl* HandleMethodsAndPropertiesWithSameNameFilter::lookupInstanceMethod(TContainerDecl* decl, clang::Selector selector)
 {
-    for (Meta* meta : container) {
-        if (meta->is(MetaType::Interface)) {
-            InterfaceMeta* interface = static_cast<InterfaceMeta*>(meta);
-            
-            const clang::ObjCInterfaceDecl* decl = clang::cast<clang::ObjCInterfaceDecl>(meta->declaration);
-
-            for (clang::ObjCPropertyDecl* propertyDecl : decl->properties()) {
-                if (clang::ObjCInterfaceDecl* parent = decl->getSuperClass()) {
-                    clang::ObjCMethodDecl* duplicate = parent->lookupInstanceMethod(propertyDecl->getGetterName());
-                    replaceMethodWithPropertyIfNecessary(duplicate, propertyDecl);
-                }
+    LookupCache::key_type key(decl, selector.getAsOpaquePtr());
+    std::pair<LookupCache::iterator, bool> insertionResult = m_instanceMethodLookups.insert(std::make_pair(key, static_cast<clang::ObjCMethodDecl*>(nullptr)));
+    if (insertionResult.second) {
+        insertionResult.first->second = decl->lookupInstanceMethod(selector);
+    }
+    return insertionResult.first->second;
+}
 
-                for (clang::ObjCProtocolDecl* protocol : decl->protocols()) {
-                    clang::ObjCMethodDecl* duplicate = protocol->lookupInstanceMethod(propertyDecl->getGetterName());
-                    replaceMethodWithPropertyIfNecessary(duplicate, propertyDecl);
-                }
+clang::ObjCMethodDecl* HandleMethodsAndPropertiesWithSameNameFilter::lookupClassPropertyAccessor(clang::ObjCInterfaceDecl* decl, clang::Selector selector)
+{
+    LookupCache::key_type key(decl, selector.getAsOpaquePtr());
+    std::pair<LookupCache::iterator, bool> insertionResult = m_classPropertyAccessorLookups.insert(std::make_pair(key, static_cast<clang::ObjCMethodDecl*>(nullptr)));
+    if (insertionResult.second) {
+        insertionResult.first->second = decl->lookupPropertyAccessor(selector, nullptr, true /*IsClassProperty*/);
+    }
+    return insertionResult.first->second;
+}
+
+void HandleMethodsAndPropertiesWithSameNameFilter::filter(MetaContainer& container)
+{
+    for (Meta* meta : container.ofType(MetaType::Interface)) {
+        InterfaceMeta* interface = static_cast<InterfaceMeta*>(meta);
+        
+        const clang::ObjCInterfaceDecl* decl = clang::cast<clang::ObjCInterfaceDecl>(meta->declaration);
+
+        for (clang::ObjCPropertyDecl* propertyDecl : decl->properties()) {
+            if (clang::ObjCInterfaceDecl* parent = decl->getSuperClass()) {
+                clang::ObjCMethodDecl* duplicate = lookupInstanceMethod(parent, propertyDecl->getGetterName());
+                replaceMethodWithPropertyIfNecessary(duplicate, propertyDecl);
             }
 
-            if (clang::ObjCInterfaceDecl* parent_decl = decl->getSuperClass()) {
-                for (clang::ObjCMethodDecl* methodDecl : decl->methods()) {
-                    if (!(methodDecl->isClassMethod() && !methodDecl->isPropertyAccessor())) {
-                        continue;
-                    }
+            for (clang::ObjCProtocolDecl* protocol : decl->protocols()) {
+                clang::ObjCMethodDecl* duplicate = lookupInstanceMethod(protocol, propertyDecl->getGetterName());
+                replaceMethodWithPropertyIfNecessary(duplicate, propertyDecl);
+            }
+        }
 
-                    if (parent_decl->lookupPropertyAccessor(methodDecl->getSelector(), nullptr, true /*IsClassProperty*/)) {
-                        deleteStaticMethod(methodDecl, decl);
-                    }
+        if (clang::ObjCInterfaceDecl* parent_decl = decl->getSuperClass()) {
+            for (clang::ObjCMethodDecl* methodDecl : decl->methods()) {
+                if (!(methodDecl->isClassMethod() && !methodDecl->isPropertyAccessor())) {
+                    continue;
+                }
+
+                if (lookupClassPropertyAccessor(parent_decl, methodDecl->getSelector())) {
+                    deleteStaticMethod(methodDecl, decl);
                 }
             }
-            
-            MethodsStructure methods;
-            for (MethodMeta* method : interface->instanceMethods) {
-                addMeta(method, &methods, true);
-            }
-            
-            // resolve collisions
-            
-            for (auto bucketIt = methods.begin(); bucketIt != methods.end(); ++bucketIt) {
-                std::vector<MethodMeta*>& metas = bucketIt->second;
-                if (metas.size() > 1) {
-                    for (std::vector<Meta*>::size_type i = 1; i < metas.size(); i++) {
-                        std::string originalJsName = metas[i]->jsName;
-                        metas[i]->jsName = MetaFactory::renameMeta(metas[i]->type, originalJsName, i);
-                    }
+        }
+        
+        MethodsStructure methods;
+        for (MethodMeta* method : interface->instanceMethods) {
+            addMeta(method, &methods, true);
+        }
+        
+        // resolve collisions
+        
+        for (auto bucketIt = methods.begin(); bucketIt != methods.end(); ++bucketIt) {
+            std::vector<MethodMeta*>& metas = bucketIt->second;
+            if (metas.size() > 1) {
+                for (std::vector<Meta*>::size_type i = 1; i < metas.size(); i++) {
+                    std::string originalJsName = metas[i]->jsName;
+                    metas[i]->jsName = MetaFactory::renameMeta(metas[i]->type, originalJsName, i);
                 }
             }
-            
         }
+        
     }
 }
 
@@ -103,20 +144,32 @@ void HandleMethodsAndPropertiesWithSameNameFilter::replaceMethodWithPropertyIfNe
         auto cachedMetaIt = cache.find(parent_decl);
         auto cachedMethodIt = cache.find(duplicateMethod);
         if (cachedMetaIt != cache.end() && cachedMethodIt != cache.end()) {
-            BaseClassMeta* parent_meta = static_cast<BaseClassMeta*>(cachedMetaIt->second.first.get());
-            MethodMeta* duplicated_method = static_cast<MethodMeta*>(cachedMethodIt->second.first.get());
+            BaseClassMeta* parent_meta = static_cast<BaseClassMeta*>(cachedMetaIt->second.meta.get());
+            MethodMeta* duplicated_method = static_cast<MethodMeta*>(cachedMethodIt->second.meta.get());
 
             std::vector<MethodMeta*>& instanceMethods = parent_meta->instanceMethods;
             auto instanceMethod = std::find(instanceMethods.begin(), instanceMethods.end(), duplicated_method);
             if (instanceMethod != instanceMethods.end()) {
-                instanceMethods.erase(instanceMethod);
-
                 clang::SourceRange parentSourceRange = parent_decl->getSourceRange();
                 clang::ObjCPropertyDecl* property_decl = clang::ObjCPropertyDecl::Create(parent_decl->getASTContext(), duplicateMethod->getDeclContext(), duplicateMethod->getSourceRange().getBegin(), duplicateMethod->getSelector().getIdentifierInfoForSlot(0), parentSourceRange.getEnd(), parentSourceRange.getBegin(), duplicateMethod->getReturnType(), duplicateMethod->getReturnTypeSourceInfo());
                 property_decl->setGetterMethodDecl(duplicateMethod);
 
-                PropertyMeta* property_meta = static_cast<PropertyMeta*>(this->m_metaFactory.create(*property_decl));
-                parent_meta->instanceProperties.push_back(property_meta);
+                // Keep the method if a property can't be created in its place
+                CreationResult<Meta*> property_meta = this->m_metaFactory.create(*property_decl);
+                if (property_meta) {
+                    instanceMethods.erase(instanceMethod);
+                    parent_meta->instanceProperties.push_back(static_cast<PropertyMeta*>(property_meta.getValue()));
+                } else {
+                    utils::Logger& logger = utils::Logger::get();
+                    if (logger.isEnabled(utils::LogLevel::Verbose)) {
+                        logger.log(utils::LogLevel::Verbose, "Keeping method " + duplicated_method->identificationString() + " instead of a property: " + property_meta.getException()->getDetailedMessage(), utils::Logger::Fields{
+                            { "action", "keep-method" },
+                            { "name", duplicated_method->name },
+                            { "jsName", duplicated_method->jsName },
+                            { "parent", parent_meta->name }
+                        });
+                    }
+                }
             }
         }
     }
@@ -148,8 +201,8 @@ void HandleMethodsAndPropertiesWithSameNameFilter::deleteStaticMethod(const clan
     auto cachedMetaIt = cache.find(owner);
     auto cachedMethodIt = cache.find(duplicateMethod);
     if (cachedMetaIt != cache.end() && cachedMethodIt != cache.end()) {
-        BaseClassMeta* parent_meta = static_cast<BaseClassMeta*>(cachedMetaIt->second.first.get());
-        MethodMeta* duplicated_method = static_cast<MethodMeta*>(cachedMethodIt->second.first.get());
+        BaseClassMeta* parent_meta = static_cast<BaseClassMeta*>(cachedMetaIt->second.meta.get());
+        MethodMeta* duplicated_method = static_cast<MethodMeta*>(cachedMethodIt->second.meta.get());
 
         std::vector<MethodMeta*>& staticMethods = parent_meta->staticMethods;
         auto staticMethod = std::find(staticMethods.begin(), staticMethods.end(), duplicated_method);
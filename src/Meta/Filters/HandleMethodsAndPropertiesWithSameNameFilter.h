@@ -1,18 +1,30 @@
 #pragma once
 
+#include "Meta/MetaContainer.h"
 #include "Meta/MetaEntities.h"
 #include "Meta/MetaFactory.h"
 #include <clang/AST/DeclObjC.h>
+#include <llvm/ADT/DenseMap.h>
 
 namespace Meta {
 class HandleMethodsAndPropertiesWithSameNameFilter {
 public:
     HandleMethodsAndPropertiesWithSameNameFilter(MetaFactory& metaFactory);
 
-    void filter(std::list<Meta*>& container);
+    void filter(MetaContainer& container);
 
 private:
+    // Results of clang lookups keyed by the declaration they have been performed on and the selector
+    typedef llvm::DenseMap<std::pair<const clang::Decl*, void*>, clang::ObjCMethodDecl*> LookupCache;
+
+    template <class TContainerDecl>
+    clang::ObjCMethodDecl* lookupInstanceMethod(TContainerDecl* decl, clang::Selector selector);
+
+    clang::ObjCMethodDecl* lookupClassPropertyAccessor(clang::ObjCInterfaceDecl* decl, clang::Selector selector);
+
     MetaFactory& m_metaFactory;
+    LookupCache m_instanceMethodLookups;
+    LookupCache m_classPropertyAccessorLookups;
     void replaceMethodWithPropertyIfNecessary(clang::ObjCMethodDecl* duplicate, clang::ObjCPropertyDecl* propertyDecl);
     void deleteStaticMethod(const clang::ObjCMethodDecl* duplicateMethod, const clang::ObjCInterfaceDecl* owner);
 };
@@ -3,74 +3,120 @@
 //
 
 #include "MergeCategoriesFilter.h"
+#include <unordered_map>
+#include <unordered_set>
 
 namespace Meta {
-static bool isCategory(Meta* meta)
-{
-    return meta->is(MetaType::Category);
-}
+// Indexes the members of an interface by name, so that all of its categories can be merged
+// without searching its member lists
+class InterfaceMembersIndex {
+public:
+    InterfaceMembersIndex(InterfaceMeta& interface)
+        : _interface(interface)
+    {
+        indexNames(interface.instanceProperties, _instancePropertyIndexes);
+        indexNames(interface.staticProperties, _staticPropertyIndexes);
+        _protocols.insert(interface.protocols.begin(), interface.protocols.end());
+    }
 
-// We shouldn't define more than 1 property with the same name
-// Whenever an extension redefines a property from the interface
-// We should choose the one which will eventually win.
-// Basically, the criteria is to choose the one that has not been deprecated or is newer
-template<class T>
-void addWithOverwrite(std::vector<T*>& v, T* newItem) {
-    auto equalNames = [&newItem](T* o) { return o->name == newItem->name; };
-
-    auto duplicateIt = std::find_if(v.begin(), v.end(), equalNames);
-
-    if (duplicateIt != v.end()) {
-        T* oldItem = *duplicateIt;
-
-        bool shouldOverwrite =
-            newItem->deprecatedIn.isGreaterThanOrUnknown(oldItem->deprecatedIn) &&
-            newItem->obsoletedIn.isGreaterThanOrUnknown(oldItem->obsoletedIn);
-        
-        if (shouldOverwrite) {
-            *duplicateIt = newItem;
+    void merge(const std::vector<CategoryMeta*>& categories)
+    {
+        size_t instanceMethodsCount = 0, staticMethodsCount = 0;
+        for (CategoryMeta* category : categories) {
+            instanceMethodsCount += category->instanceMethods.size();
+            staticMethodsCount += category->staticMethods.size();
         }
+        _interface.instanceMethods.reserve(_interface.instanceMethods.size() + instanceMethodsCount);
+        _interface.staticMethods.reserve(_interface.staticMethods.size() + staticMethodsCount);
 
-    } else {
-        v.push_back(newItem);
-    }
-}
-    
-void MergeCategoriesFilter::filter(std::list<Meta*>& container)
-{
-    int mergedCategories = 0;
-    
-    for (Meta* meta : container) {
-        if (meta->is(MetaType::Category)) {
-            CategoryMeta& category = meta->as<CategoryMeta>();
-            assert(category.extendedInterface != nullptr);
-            InterfaceMeta& interface = *category.extendedInterface;
-
-            for (auto& method : category.instanceMethods) {
-                interface.instanceMethods.push_back(method);
-            }
+        for (CategoryMeta* category : categories) {
+            _interface.instanceMethods.insert(_interface.instanceMethods.end(), category->instanceMethods.begin(), category->instanceMethods.end());
+            _interface.staticMethods.insert(_interface.staticMethods.end(), category->staticMethods.begin(), category->staticMethods.end());
 
-            for (auto& method : category.staticMethods) {
-                interface.staticMethods.push_back(method);
+            for (PropertyMeta* property : category->instanceProperties) {
+                addWithOverwrite(_interface.instanceProperties, _instancePropertyIndexes, property);
             }
 
-            for (auto& property : category.instanceProperties) {
-                addWithOverwrite(interface.instanceProperties, property);
+            for (PropertyMeta* property : category->staticProperties) {
+                addWithOverwrite(_interface.staticProperties, _staticPropertyIndexes, property);
             }
 
-            for (auto& property : category.staticProperties) {
-                addWithOverwrite(interface.staticProperties, property);
+            for (ProtocolMeta* protocol : category->protocols) {
+                if (_protocols.insert(protocol).second) {
+                    _interface.protocols.push_back(protocol);
+                }
             }
+        }
+    }
+
+private:
+    typedef std::unordered_map<std::string, size_t> NameIndexes;
+
+    template <class T>
+    static void indexNames(const std::vector<T*>& v, NameIndexes& indexes)
+    {
+        for (size_t i = 0; i < v.size(); i++) {
+            // Keep the first one, it is the one which is looked up by name
+            indexes.insert(std::make_pair(v[i]->name, i));
+        }
+    }
 
-            for (auto& protocol : category.protocols) {
-                interface.protocols.push_back(protocol);
+    // We shouldn't define more than 1 property with the same name
+    // Whenever an extension redefines a property from the interface
+    // We should choose the one which will eventually win.
+    // Basically, the criteria is to choose the one that has not been deprecated or is newer
+    template <class T>
+    static void addWithOverwrite(std::vector<T*>& v, NameIndexes& indexes, T* newItem)
+    {
+        NameIndexes::iterator duplicateIt = indexes.find(newItem->name);
+
+        if (duplicateIt != indexes.end()) {
+            T*& oldItem = v[duplicateIt->second];
+
+            bool shouldOverwrite =
+                newItem->deprecatedIn.isGreaterThanOrUnknown(oldItem->deprecatedIn) &&
+                newItem->obsoletedIn.isGreaterThanOrUnknown(oldItem->obsoletedIn);
+
+            if (shouldOverwrite) {
+                oldItem = newItem;
             }
 
-            mergedCategories++;
+        } else {
+            indexes.insert(std::make_pair(newItem->name, v.size()));
+            v.push_back(newItem);
         }
     }
 
-    container.remove_if(isCategory);
+    InterfaceMeta& _interface;
+    NameIndexes _instancePropertyIndexes;
+    NameIndexes _staticPropertyIndexes;
+    std::unordered_set<ProtocolMeta*> _protocols;
+};
+
+void MergeCategoriesFilter::filter(MetaContainer& container)
+{
+    int mergedCategories = 0;
+
+    // Group the categories by the interface they extend, keeping their order
+    std::vector<InterfaceMeta*> extendedInterfaces;
+    std::unordered_map<InterfaceMeta*, std::vector<CategoryMeta*> > categoriesByInterface;
+    for (Meta* meta : container.ofType(MetaType::Category)) {
+        CategoryMeta& category = meta->as<CategoryMeta>();
+        assert(category.extendedInterface != nullptr);
+        std::vector<CategoryMeta*>& categories = categoriesByInterface[category.extendedInterface];
+        if (categories.empty()) {
+            extendedInterfaces.push_back(category.extendedInterface);
+        }
+        categories.push_back(&category);
+
+        mergedCategories++;
+    }
+
+    for (InterfaceMeta* interface : extendedInterfaces) {
+        InterfaceMembersIndex(*interface).merge(categoriesByInterface[interface]);
+    }
+
+    container.removeAll(MetaType::Category);
     std::cout << "Merged " << mergedCategories << " categories." << std::endl;
 }
 }
@@ -2,11 +2,12 @@
 // Created by Ivan Buhov on 9/5/15.
 //
 #pragma once
+#include "Meta/MetaContainer.h"
 #include "Meta/MetaEntities.h"
 
 namespace Meta {
 class MergeCategoriesFilter {
 public:
-    void filter(std::list<Meta*>& container);
+    void filter(MetaContainer& container);
 };
 }
\ No newline at end of file
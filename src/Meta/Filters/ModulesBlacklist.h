@@ -11,23 +11,111 @@
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <unordered_map>
+#include <clang/Basic/Module.h>
+#include <llvm/ADT/SmallVector.h>
 #include <llvm/ADT/StringRef.h>
 #include <llvm/Support/Regex.h>
 
 namespace Meta {
 
+// A wildcard pattern in which '*' matches any sequence of characters and '?' matches a single character.
+// The pattern is split on '*' once, so matching is a linear scan instead of recursive backtracking.
+class GlobPattern {
+public:
+    explicit GlobPattern(const std::string& pattern)
+    {
+        llvm::SmallVector<llvm::StringRef, 4> segments;
+        llvm::StringRef(pattern).split(segments, '*');
+        _hasWildcard = segments.size() > 1;
+        _prefix = segments.front().str();
+        for (size_t i = 1; i + 1 < segments.size(); i++) {
+            if (!segments[i].empty()) {
+                _segments.push_back(segments[i].str());
+            }
+        }
+        if (_hasWildcard) {
+            _suffix = segments.back().str();
+        }
+    }
+
+    bool match(llvm::StringRef string) const
+    {
+        if (!_hasWildcard) {
+            return string.size() == _prefix.size() && matchesAt(_prefix, string, 0);
+        }
+        if (string.size() < _prefix.size() + _suffix.size() || !matchesAt(_prefix, string, 0) || !matchesAt(_suffix, string, string.size() - _suffix.size())) {
+            return false;
+        }
+
+        // Each segment between two '*'s is matched at its leftmost possible position
+        size_t position = _prefix.size();
+        size_t end = string.size() - _suffix.size();
+        for (const std::string& segment : _segments) {
+            while (position + segment.size() <= end && !matchesAt(segment, string, position)) {
+                position++;
+            }
+            if (position + segment.size() > end) {
+                return false;
+            }
+            position += segment.size();
+        }
+        return true;
+    }
+
+private:
+    static bool matchesAt(const std::string& segment, llvm::StringRef string, size_t position)
+    {
+        for (size_t i = 0; i < segment.size(); i++) {
+            if (segment[i] != '?' && segment[i] != string[position + i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool _hasWildcard;
+    std::string _prefix;
+    std::vector<std::string> _segments;
+    std::string _suffix;
+};
+
 class ModulesBlacklist {
 private:
     struct ModuleAndSymbolNamePatterns {
+        ModuleAndSymbolNamePatterns(const std::string& modulePattern, const std::string& symbolPattern)
+            : modulePattern(modulePattern)
+            , symbolPattern(symbolPattern)
+            , compiledModulePattern(modulePattern)
+            , compiledSymbolPattern(symbolPattern)
+        {
+        }
+
         std::string modulePattern;
         std::string symbolPattern;
+        GlobPattern compiledModulePattern;
+        GlobPattern compiledSymbolPattern;
         
-        std::string toString() {
+        std::string toString() const {
             return this->modulePattern + ":" + this->symbolPattern;
         }
+
+        bool matchesModule(llvm::StringRef moduleName) const {
+            return this->modulePattern.empty() || this->compiledModulePattern.match(moduleName);
+        }
+
+        bool matchesSymbol(llvm::StringRef symbolName) const {
+            return this->symbolPattern.empty() || this->compiledSymbolPattern.match(symbolName);
+        }
     };
     typedef std::vector<ModuleAndSymbolNamePatterns> ModuleAndSymbolNamePatternsList;
 
+    // The patterns whose module part matches a given module, in their original order
+    struct ModulePatterns {
+        std::vector<const ModuleAndSymbolNamePatterns*> whitelist;
+        std::vector<const ModuleAndSymbolNamePatterns*> blacklist;
+    };
+
 public:
     ModulesBlacklist(std::string& whitelistFileName, std::string& blacklistFileName) {
         this->_whitelistDefined = !whitelistFileName.empty();
@@ -35,65 +123,51 @@ public:
         fillPatternsFromFile(blacklistFileName, /*r*/this->_blacklist);
     }
 
-    bool shouldBlacklist(std::string moduleName, std::string symbolName, std::string& enabledBy, std::string& disabledBy) {
-        auto findMatchingPattern = [&moduleName, &symbolName](ModuleAndSymbolNamePatternsList& v) {
-            return std::find_if(v.begin(), v.end(), [&moduleName, &symbolName](ModuleAndSymbolNamePatterns& item) {
-                return
-                    (item.modulePattern.empty() ||
-                     match(item.modulePattern.c_str(), moduleName.c_str()))
-                &&
-                    (item.symbolPattern.empty() ||
-                     match(item.symbolPattern.c_str(), symbolName.c_str()));
+    bool shouldBlacklist(const clang::Module* module, llvm::StringRef symbolName, std::string& enabledBy, std::string& disabledBy) {
+        const ModulePatterns& modulePatterns = this->getModulePatterns(module);
+        auto findMatchingPattern = [&symbolName](const std::vector<const ModuleAndSymbolNamePatterns*>& v) {
+            return std::find_if(v.begin(), v.end(), [&symbolName](const ModuleAndSymbolNamePatterns* item) {
+                return item->matchesSymbol(symbolName);
             });
         };
         
         bool enabledByWhitelist = true;
         if (this->_whitelistDefined) {
-            auto it = findMatchingPattern(this->_whitelist);
-            enabledByWhitelist = it != this->_whitelist.end();
+            auto it = findMatchingPattern(modulePatterns.whitelist);
+            enabledByWhitelist = it != modulePatterns.whitelist.end();
             if (enabledByWhitelist) {
-                enabledBy = it->toString();
+                enabledBy = (*it)->toString();
             }
         }
         
-        auto itBlacklist = findMatchingPattern(this->_blacklist);
-        bool disabledByBlacklist = itBlacklist != this->_blacklist.end();
+        auto itBlacklist = findMatchingPattern(modulePatterns.blacklist);
+        bool disabledByBlacklist = itBlacklist != modulePatterns.blacklist.end();
         if (disabledByBlacklist) {
-            disabledBy = itBlacklist->toString();
+            disabledBy = (*itBlacklist)->toString();
         }
 
         return disabledByBlacklist || !enabledByWhitelist;
     }
 
 private:
-    // Taken from https://www.geeksforgeeks.org/wildcard-character-matching/
-    static bool match(const char* pattern, const char* string)
-    {
-        // If we reach at the end of both strings, we are done
-        if (*pattern == '\0' && *string == '\0')
-            return true;
-        
-        // pattern "*" matches everything, done checking
-        if (pattern[0] == '*' && pattern[1] == '\0')
-            return true;
-        
-        // Make sure that the characters after '*' are present
-        // in second string. This function assumes that the first
-        // string will not contain two consecutive '*'
-        if (*pattern == '*' && *(pattern+1) != '\0' && *string == '\0')
-            return false;
-      
-        // If the first string contains '?', or current characters
-        // of both strings match
-        if (*pattern == '?' || *pattern == *string)
-            return match(pattern+1, string+1);
-      
-        // If there is *, then there are two possibilities
-        // a) We consider current character of second string
-        // b) We ignore current character of second string.
-        if (*pattern == '*')
-            return match(pattern+1, string) || match(pattern, string+1);
-        return false;
+    // Matches the module patterns only once per module
+    const ModulePatterns& getModulePatterns(const clang::Module* module) {
+        std::pair<std::unordered_map<const clang::Module*, ModulePatterns>::iterator, bool> insertionResult = this->_modulePatterns.emplace(module, ModulePatterns());
+        ModulePatterns& modulePatterns = insertionResult.first->second;
+        if (insertionResult.second) {
+            std::string moduleName = module->getFullModuleName();
+            for (const ModuleAndSymbolNamePatterns& item : this->_whitelist) {
+                if (item.matchesModule(moduleName)) {
+                    modulePatterns.whitelist.push_back(&item);
+                }
+            }
+            for (const ModuleAndSymbolNamePatterns& item : this->_blacklist) {
+                if (item.matchesModule(moduleName)) {
+                    modulePatterns.blacklist.push_back(&item);
+                }
+            }
+        }
+        return modulePatterns;
     }
     
     static void fillPatternsFromFile(const std::string& opt, ModuleAndSymbolNamePatternsList &regexList) {
@@ -112,7 +186,7 @@ private:
                     std::size_t colon = line.find(':');
                     std::string modulePattern = line.substr(0, colon);
                     std::string symbolPattern = colon != std::string::npos ? line.substr(colon+1) : std::string();
-                    regexList.push_back({ modulePattern, symbolPattern });
+                    regexList.push_back(ModuleAndSymbolNamePatterns(modulePattern, symbolPattern));
                 }
             }
         }
@@ -121,6 +195,7 @@ private:
     bool _whitelistDefined = false;
     ModuleAndSymbolNamePatternsList _whitelist;
     ModuleAndSymbolNamePatternsList _blacklist;
+    std::unordered_map<const clang::Module*, ModulePatterns> _modulePatterns;
 };
 
 } // namespace Meta
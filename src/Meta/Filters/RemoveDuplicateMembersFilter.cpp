@@ -1,5 +1,8 @@
 #include "RemoveDuplicateMembersFilter.h"
+#include "Meta/ClassHierarchy.h"
 #include "Meta/Utils.h"
+#include <algorithm>
+#include <unordered_map>
 
 namespace Meta {
 static bool areMethodsEqual(MethodMeta& method1, MethodMeta& method2)
@@ -20,61 +23,148 @@ static bool arePropertiesEqual(PropertyMeta& prop1, PropertyMeta& prop2)
     return false;
 }
 
-static void removeDuplicateMethods(std::vector<MethodMeta*>& from, std::vector<MethodMeta*>& duplicates)
+static bool areMembersEqual(MethodMeta& method1, MethodMeta& method2)
 {
-    for (MethodMeta* dupMethod : duplicates) {
-        from.erase(std::remove_if(from.begin(),
-                       from.end(),
-                       [&](MethodMeta* method) {
-                           return areMethodsEqual(*method, *dupMethod);
-                       }),
-            from.end());
+    return areMethodsEqual(method1, method2);
+}
+
+static bool areMembersEqual(PropertyMeta& prop1, PropertyMeta& prop2)
+{
+    return arePropertiesEqual(prop1, prop2);
+}
+
+// Equal methods always have equal hashes. Only the kinds of the signature types are hashed,
+// the rest of the comparison is left to areMethodsEqual.
+static size_t hashMember(MethodMeta& method)
+{
+    size_t hash = std::hash<std::string>()(method.name);
+    hash = hash * 31 + method.signature.size();
+    for (Type* type : method.signature) {
+        hash = hash * 31 + static_cast<size_t>(type->getType());
     }
+    return hash;
 }
 
-static void removeDuplicateProperties(std::vector<PropertyMeta*>& from, std::vector<PropertyMeta*>& duplicates)
+static size_t hashMember(PropertyMeta& property)
 {
-    for (PropertyMeta* dupProperty : duplicates) {
+    size_t hash = std::hash<std::string>()(property.name);
+    hash = hash * 31 + (property.getter ? 1 : 0) + (property.setter ? 2 : 0);
+    if (MethodMeta* accessor = property.getter ? property.getter : property.setter) {
+        hash = hash * 31 + hashMember(*accessor);
+    }
+    return hash;
+}
+
+/*
+ * \class MemberSet<T>
+ * \brief A set of methods or properties indexed by the hash of their signature.
+ *
+ * Members which are equal to an already added member are not added again.
+ */
+template <class T>
+class MemberSet {
+public:
+    bool contains(T& member) const
+    {
+        return this->find(member, hashMember(member));
+    }
+
+    void insert(T* member)
+    {
+        size_t hash = hashMember(*member);
+        if (!this->find(*member, hash)) {
+            _members.insert(std::make_pair(hash, member));
+        }
+    }
+
+    void insert(const std::vector<T*>& members)
+    {
+        for (T* member : members) {
+            this->insert(member);
+        }
+    }
+
+    void insert(const MemberSet<T>& members)
+    {
+        for (const auto& pair : members._members) {
+            this->insert(pair.second);
+        }
+    }
+
+    void removeFrom(std::vector<T*>& from) const
+    {
         from.erase(std::remove_if(from.begin(),
                        from.end(),
-                       [&](PropertyMeta* property) {
-                           return arePropertiesEqual(*property, *dupProperty);
+                       [&](T* member) {
+                           return this->contains(*member);
                        }),
             from.end());
     }
+
+private:
+    bool find(T& member, size_t hash) const
+    {
+        auto range = _members.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (areMembersEqual(*it->second, member)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::unordered_multimap<size_t, T*> _members;
+};
+
+struct HierarchyMembers {
+    MemberSet<MethodMeta> staticMethods;
+    MemberSet<MethodMeta> instanceMethods;
+    MemberSet<PropertyMeta> instanceProperties;
+    MemberSet<PropertyMeta> staticProperties;
+};
+
+typedef std::unordered_map<BaseClassMeta*, HierarchyMembers> AncestorMembersMap;
+
+static void addMembersOfHierarchy(HierarchyMembers& members, BaseClassMeta* parent, const HierarchyMembers& parentAncestorMembers)
+{
+    members.staticMethods.insert(parent->staticMethods);
+    members.instanceMethods.insert(parent->instanceMethods);
+    members.instanceProperties.insert(parent->instanceProperties);
+    members.staticProperties.insert(parent->staticProperties);
+
+    members.staticMethods.insert(parentAncestorMembers.staticMethods);
+    members.instanceMethods.insert(parentAncestorMembers.instanceMethods);
+    members.instanceProperties.insert(parentAncestorMembers.instanceProperties);
+    members.staticProperties.insert(parentAncestorMembers.staticProperties);
 }
 
-static void removeDuplicateMembersFromChild(BaseClassMeta* child, BaseClassMeta* parent)
+static void removeDuplicateMembersOf(BaseClassMeta* child, const HierarchyMembers& ancestorMembers)
 {
-    removeDuplicateMethods(child->staticMethods, parent->staticMethods);
-    removeDuplicateMethods(child->instanceMethods, parent->instanceMethods);
-    removeDuplicateProperties(child->instanceProperties, parent->instanceProperties);
-    removeDuplicateProperties(child->staticProperties, parent->staticProperties);
+    ancestorMembers.staticMethods.removeFrom(child->staticMethods);
+    ancestorMembers.instanceMethods.removeFrom(child->instanceMethods);
+    ancestorMembers.instanceProperties.removeFrom(child->instanceProperties);
+    ancestorMembers.staticProperties.removeFrom(child->staticProperties);
 }
 
-static void processBaseClassAndHierarchyOf(BaseClassMeta* child, BaseClassMeta* parent)
+void RemoveDuplicateMembersFilter::filter(MetaContainer& container)
 {
-    if (child != parent) {
-        removeDuplicateMembersFromChild(child, parent);
-    }
-    for (ProtocolMeta* protocol : parent->protocols) {
-        processBaseClassAndHierarchyOf(child, protocol);
-    }
-    if (parent->is(MetaType::Interface)) {
-        InterfaceMeta* parentInterface = &parent->as<InterfaceMeta>();
-        if (parentInterface->base != nullptr) {
-            processBaseClassAndHierarchyOf(child, parentInterface->base);
+    // Collect the members of all protocols and base classes of each class (but not its own) in a single
+    // pass over the hierarchy. A member which is removed from an ancestor has an equal member further up
+    // in the hierarchy, so it doesn't matter that the ancestors' own members are read before they are filtered.
+    ClassHierarchy hierarchy(container);
+    AncestorMembersMap ancestorMembers;
+    for (BaseClassMeta* meta : hierarchy.getTopologicalOrder()) {
+        HierarchyMembers& members = ancestorMembers[meta];
+        for (BaseClassMeta* parent : ClassHierarchy::getParents(meta)) {
+            addMembersOfHierarchy(members, parent, ancestorMembers[parent]);
         }
     }
-}
 
-void RemoveDuplicateMembersFilter::filter(std::list<Meta*>& container)
-{
-    for (Meta* meta : container) {
-        if (meta->is(MetaType::Interface) || meta->is(MetaType::Protocol)) {
+    for (MetaType type : { MetaType::Interface, MetaType::Protocol }) {
+        for (Meta* meta : container.ofType(type)) {
             BaseClassMeta* baseClass = &meta->as<BaseClassMeta>();
-            processBaseClassAndHierarchyOf(baseClass, baseClass);
+            removeDuplicateMembersOf(baseClass, ancestorMembers[baseClass]);
         }
     }
 }
-}
\ No newline at end of file
+}
@@ -1,9 +1,10 @@
 #pragma once
+#include "Meta/MetaContainer.h"
 #include "Meta/MetaEntities.h"
 
 namespace Meta {
 class RemoveDuplicateMembersFilter {
 public:
-    void filter(std::list<Meta*>& container);
+    void filter(MetaContainer& container);
 };
 }
\ No newline at end of file
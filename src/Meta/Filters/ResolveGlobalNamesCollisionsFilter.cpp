@@ -35,7 +35,7 @@ static bool metasComparerByPriority(Meta* meta1, Meta* meta2)
 {
     return getPriority(meta1) > getPriority(meta2);
 }
-void ResolveGlobalNamesCollisionsFilter::filter(std::list<Meta*>& container)
+void ResolveGlobalNamesCollisionsFilter::filter(MetaContainer& container)
 {
 
     // order meta objects by modules and names
@@ -2,6 +2,7 @@
 // Created by Ivan Buhov on 9/6/15.
 //
 #pragma once
+#include "Meta/MetaContainer.h"
 #include "Meta/MetaEntities.h"
 
 namespace Meta {
@@ -16,7 +17,7 @@ public:
     typedef std::unordered_map<std::string, InterfaceMeta*> InterfacesByName;
     typedef std::unordered_map<clang::Module*, std::unordered_map<std::string, std::vector<Meta*> > > ModulesStructure;
 
-    void filter(std::list<Meta*>& container);
+    void filter(MetaContainer& container);
 
     std::unique_ptr<std::pair<MetasByModules, InterfacesByName> > getResult()
     {
@@ -0,0 +1,26 @@
+#include "MetaContainer.h"
+#include <cassert>
+
+namespace Meta {
+void MetaContainer::push_back(Meta* meta)
+{
+    assert(meta != nullptr && static_cast<size_t>(meta->type) < MetaTypesCount);
+    _metasByType[meta->type].push_back(meta);
+    _indexesByType[meta->type].push_back(_metas.size());
+    _metas.push_back(meta);
+    _size++;
+}
+
+void MetaContainer::removeAll(MetaType type)
+{
+    this->remove_if(type, [](Meta*) { return true; });
+}
+
+void MetaContainer::remove(MetaType type, size_t index)
+{
+    assert(_metasByType[type][index] != nullptr);
+    _metasByType[type][index] = nullptr;
+    _metas[_indexesByType[type][index]] = nullptr;
+    _size--;
+}
+}
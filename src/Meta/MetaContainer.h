@@ -0,0 +1,135 @@
+#pragma once
+#include "MetaEntities.h"
+#include <iterator>
+#include <vector>
+
+namespace Meta {
+/*
+ * \class MetaContainer
+ * \brief Holds the converted metas in contiguous vectors partitioned by meta type.
+ *
+ * Removed metas are left as tombstones (nullptr) so the indices of the remaining ones stay stable.
+ * Iterating the container visits all metas in insertion order, while ofType() visits only the metas
+ * of a single type (also in insertion order).
+ */
+class MetaContainer {
+public:
+    // Iterates over a vector of metas skipping the removed ones
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Meta* value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Meta* const* pointer;
+        typedef Meta* const& reference;
+
+        const_iterator(std::vector<Meta*>::const_iterator current, std::vector<Meta*>::const_iterator end)
+            : _current(current)
+            , _end(end)
+        {
+            skipRemoved();
+        }
+
+        reference operator*() const
+        {
+            return *_current;
+        }
+
+        const_iterator& operator++()
+        {
+            ++_current;
+            skipRemoved();
+            return *this;
+        }
+
+        bool operator==(const const_iterator& other) const
+        {
+            return _current == other._current;
+        }
+
+        bool operator!=(const const_iterator& other) const
+        {
+            return _current != other._current;
+        }
+
+    private:
+        void skipRemoved()
+        {
+            while (_current != _end && *_current == nullptr) {
+                ++_current;
+            }
+        }
+
+        std::vector<Meta*>::const_iterator _current;
+        std::vector<Meta*>::const_iterator _end;
+    };
+
+    class Range {
+    public:
+        explicit Range(const std::vector<Meta*>& metas)
+            : _metas(metas)
+        {
+        }
+
+        const_iterator begin() const
+        {
+            return const_iterator(_metas.begin(), _metas.end());
+        }
+
+        const_iterator end() const
+        {
+            return const_iterator(_metas.end(), _metas.end());
+        }
+
+    private:
+        const std::vector<Meta*>& _metas;
+    };
+
+    void push_back(Meta* meta);
+
+    const_iterator begin() const
+    {
+        return Range(_metas).begin();
+    }
+
+    const_iterator end() const
+    {
+        return Range(_metas).end();
+    }
+
+    Range ofType(MetaType type) const
+    {
+        return Range(_metasByType[type]);
+    }
+
+    // The number of metas which haven't been removed
+    size_t size() const
+    {
+        return _size;
+    }
+
+    template <class Predicate>
+    void remove_if(MetaType type, Predicate predicate)
+    {
+        std::vector<Meta*>& metas = _metasByType[type];
+        for (size_t i = 0; i < metas.size(); i++) {
+            if (metas[i] != nullptr && predicate(metas[i])) {
+                remove(type, i);
+            }
+        }
+    }
+
+    void removeAll(MetaType type);
+
+private:
+    static const size_t MetaTypesCount = MetaType::EnumConstant + 1;
+
+    void remove(MetaType type, size_t index);
+
+    std::vector<Meta*> _metas;
+    std::vector<Meta*> _metasByType[MetaTypesCount];
+    // The index in _metas of each meta in _metasByType
+    std::vector<size_t> _indexesByType[MetaTypesCount];
+    size_t _size = 0;
+};
+}
@@ -25,26 +25,37 @@ static bool metasComparerByJsName(Meta* meta1, Meta* meta2)
     return compareJsNames(meta1->jsName, meta2->jsName);
 }
 
-void MetaFactory::validate(Type* type)
+std::shared_ptr<CreationException> MetaFactory::validate(Type* type)
 {
     ValidateMetaTypeVisitor validator(*this);
     
     type->visit(validator);
+    return validator.getException();
 }
 
-void MetaFactory::validate(Meta* meta)
+std::shared_ptr<CreationException> MetaFactory::validate(Meta* meta)
 {
     auto declIt = this->_metaToDecl.find(meta);
     if (declIt == this->_metaToDecl.end()) {
-        throw MetaCreationException(meta, "Metadata not created", true);
+        return std::make_shared<MetaCreationException>(meta, "Metadata not created", true);
     }
 
     auto metaIt = this->_cache.find(declIt->second);
     assert(metaIt != this->_cache.end());
-    if (metaIt->second.second.get() != nullptr) {
-//        printf("**** Validation failed for %s: %s ***\n\n", meta->name.c_str(), metaIt->second.second.c_str());
-        POLYMORPHIC_THROW(metaIt->second.second);
+    MetaCacheEntry& entry = metaIt->second;
+    if (entry.exception.get() != nullptr) {
+//        printf("**** Validation failed for %s: %s ***\n\n", meta->name.c_str(), entry.exception->getMessage().c_str());
+        return entry.exception;
     }
+
+    int pendingIndex = this->getPendingCreationIndex(entry);
+    if (pendingIndex >= 0) {
+        this->registerPendingDependency(pendingIndex);
+    } else if (entry.pendingDependency != nullptr) {
+        // Its dependencies are complete now, recreate it to find out whether it is still valid
+        return this->create(*declIt->second).getException();
+    }
+    return nullptr;
 }
     
 string MetaFactory::getTypedefOrOwnName(const clang::TagDecl* tagDecl)
@@ -69,7 +80,7 @@ string MetaFactory::getTypedefOrOwnName(const clang::TagDecl* tagDecl)
 }
 
 template<class T>
-void resetMetaAndAddToMap(std::unique_ptr<Meta>& metaPtrRef, MetaToDeclMap& metaToDecl, const clang::Decl& decl) {
+static std::shared_ptr<CreationException> resetMetaAndAddToMap(std::unique_ptr<Meta>& metaPtrRef, MetaToDeclMap& metaToDecl, const clang::Decl& decl) {
     if (metaPtrRef.get()) {
         // The pointer has been previously allocated. Reset it's value and assert that it's already present in the map
         static_cast<T&>(*metaPtrRef) = T();
@@ -81,137 +92,223 @@ void resetMetaAndAddToMap(std::unique_ptr<Meta>& metaPtrRef, MetaToDeclMap& meta
     }
     
     if (decl.isInvalidDecl()) {
-        std::string declDump;
-        llvm::raw_string_ostream os(declDump);
-        decl.dump(os);
-        throw MetaCreationException(metaPtrRef.get(), CreationException::constructMessage("Invalid decl.", os.str()), true);
+        return std::make_shared<MetaCreationException>(metaPtrRef.get(), &decl);
     }
+    return nullptr;
 }
 
-Meta* MetaFactory::create(const clang::Decl& decl, bool resetCached /* = false*/)
+template <class TMeta, class TDecl>
+std::shared_ptr<CreationException> MetaFactory::createMeta(const TDecl& decl, std::unique_ptr<Meta>& metaPtrRef, std::shared_ptr<CreationException> (MetaFactory::*createFrom)(const TDecl&, TMeta&))
+{
+    if (auto exception = resetMetaAndAddToMap<TMeta>(metaPtrRef, this->_metaToDecl, decl)) {
+        return exception;
+    }
+    if (auto exception = this->populateIdentificationFields(decl, *metaPtrRef.get())) {
+        return exception;
+    }
+    return (this->*createFrom)(decl, metaPtrRef.get()->as<TMeta>());
+}
+
+CreationResult<Meta*> MetaFactory::create(const clang::Decl& decl)
 {
     // Check for cached Meta
     Cache::iterator cachedMetaIt = _cache.find(&decl);
-    if (!resetCached && cachedMetaIt != _cache.end()) {
-        Meta* meta = cachedMetaIt->second.first.get();
-        if (auto creationException = cachedMetaIt->second.second.get()) {
-            POLYMORPHIC_THROW(creationException);
+    if (cachedMetaIt != _cache.end()) {
+        MetaCacheEntry& cachedEntry = cachedMetaIt->second;
+        if (cachedEntry.exception) {
+            return cachedEntry.exception;
         }
 
-        /* TODO: The meta object is not guaranteed to be fully initialized. If the meta object is in the creation stack
-             * it will appear in cache, but will not be fully initialized. This may cause some inconsistent results.
-             * */
-        
-        return meta;
-    }
+        int pendingIndex = this->getPendingCreationIndex(cachedEntry);
+        if (pendingIndex >= 0) {
+            // The meta (or a meta it depends on) is in the creation stack and is not fully initialized yet.
+            // Remember that everything being created on top of it depends on its outcome.
+            this->registerPendingDependency(pendingIndex);
+            return cachedEntry.meta.get();
+        }
+
+        if (cachedEntry.pendingDependency == nullptr) {
+            return cachedEntry.meta.get();
+        }
 
-    if (cachedMetaIt == _cache.end()) {
-        std::pair<Cache::iterator, bool> insertionResult = _cache.insert(std::make_pair(&decl, std::make_pair(nullptr, nullptr)));
+        // The meta has been completed while one of its dependencies was still being created. The dependency is
+        // complete now and may have failed in the meantime, so the meta is created again to reflect that.
+        cachedEntry.pendingDependency = nullptr;
+    } else {
+        std::pair<Cache::iterator, bool> insertionResult = _cache.insert(std::make_pair(&decl, MetaCacheEntry()));
         assert(insertionResult.second);
         cachedMetaIt = insertionResult.first;
     }
-    std::unique_ptr<Meta>& insertedMetaPtrRef = cachedMetaIt->second.first;
-    std::unique_ptr<CreationException>& insertedException = cachedMetaIt->second.second;
-
-    try {
-        if (const clang::FunctionDecl* function = clang::dyn_cast<clang::FunctionDecl>(&decl)) {
-            resetMetaAndAddToMap<FunctionMeta>(insertedMetaPtrRef, this->_metaToDecl, decl);
-            populateIdentificationFields(*function, *insertedMetaPtrRef.get());
-            createFromFunction(*function, insertedMetaPtrRef.get()->as<FunctionMeta>());
-        } else if (const clang::RecordDecl* record = clang::dyn_cast<clang::RecordDecl>(&decl)) {
-            if (record->isStruct()) {
-                resetMetaAndAddToMap<StructMeta>(insertedMetaPtrRef, this->_metaToDecl, decl);
-                populateIdentificationFields(*record, *insertedMetaPtrRef.get());
-                createFromStruct(*record, insertedMetaPtrRef.get()->as<StructMeta>());
-            } else {
-                resetMetaAndAddToMap<UnionMeta>(insertedMetaPtrRef, this->_metaToDecl, decl);
-                populateIdentificationFields(*record, *insertedMetaPtrRef.get());
-                throw MetaCreationException(insertedMetaPtrRef.get(), "The record is union.", false);
-            }
-        } else if (const clang::VarDecl* var = clang::dyn_cast<clang::VarDecl>(&decl)) {
-            resetMetaAndAddToMap<VarMeta>(insertedMetaPtrRef, this->_metaToDecl, decl);
-            populateIdentificationFields(*var, *insertedMetaPtrRef.get());
-            createFromVar(*var, insertedMetaPtrRef.get()->as<VarMeta>());
-        } else if (const clang::EnumDecl* enumDecl = clang::dyn_cast<clang::EnumDecl>(&decl)) {
-            resetMetaAndAddToMap<EnumMeta>(insertedMetaPtrRef, this->_metaToDecl, decl);
-            populateIdentificationFields(*enumDecl, *insertedMetaPtrRef.get());
-            createFromEnum(*enumDecl, insertedMetaPtrRef.get()->as<EnumMeta>());
-        } else if (const clang::EnumConstantDecl* enumConstantDecl = clang::dyn_cast<clang::EnumConstantDecl>(&decl)) {
-            resetMetaAndAddToMap<EnumConstantMeta>(insertedMetaPtrRef, this->_metaToDecl, decl);
-            populateIdentificationFields(*enumConstantDecl, *insertedMetaPtrRef.get());
-            createFromEnumConstant(*enumConstantDecl, insertedMetaPtrRef.get()->as<EnumConstantMeta>());
-        } else if (const clang::ObjCInterfaceDecl* interface = clang::dyn_cast<clang::ObjCInterfaceDecl>(&decl)) {
-            resetMetaAndAddToMap<InterfaceMeta>(insertedMetaPtrRef, this->_metaToDecl, decl);
-            populateIdentificationFields(*interface, *insertedMetaPtrRef.get());
-            createFromInterface(*interface, insertedMetaPtrRef.get()->as<InterfaceMeta>());
-        } else if (const clang::ObjCProtocolDecl* protocol = clang::dyn_cast<clang::ObjCProtocolDecl>(&decl)) {
-            resetMetaAndAddToMap<ProtocolMeta>(insertedMetaPtrRef, this->_metaToDecl, decl);
-            populateIdentificationFields(*protocol, *insertedMetaPtrRef.get());
-            createFromProtocol(*protocol, insertedMetaPtrRef.get()->as<ProtocolMeta>());
-        } else if (const clang::ObjCCategoryDecl* category = clang::dyn_cast<clang::ObjCCategoryDecl>(&decl)) {
-            resetMetaAndAddToMap<CategoryMeta>(insertedMetaPtrRef, this->_metaToDecl, decl);
-            populateIdentificationFields(*category, *insertedMetaPtrRef.get());
-            createFromCategory(*category, insertedMetaPtrRef.get()->as<CategoryMeta>());
-        } else if (const clang::ObjCMethodDecl* method = clang::dyn_cast<clang::ObjCMethodDecl>(&decl)) {
-            resetMetaAndAddToMap<MethodMeta>(insertedMetaPtrRef, this->_metaToDecl, decl);
-            populateIdentificationFields(*method, *insertedMetaPtrRef.get());
-            createFromMethod(*method, insertedMetaPtrRef.get()->as<MethodMeta>());
-        } else if (const clang::ObjCPropertyDecl* property = clang::dyn_cast<clang::ObjCPropertyDecl>(&decl)) {
-            resetMetaAndAddToMap<PropertyMeta>(insertedMetaPtrRef, this->_metaToDecl, decl);
-            populateIdentificationFields(*property, *insertedMetaPtrRef.get());
-            createFromProperty(*property, insertedMetaPtrRef.get()->as<PropertyMeta>());
+    // Creating a meta after the filters have run would overwrite their changes, or race with the TypeScript writers
+    assert(!this->_isFrozen && "Metas can't be created after the filters have run.");
+    MetaCacheEntry& entry = cachedMetaIt->second;
+    std::unique_ptr<Meta>& insertedMetaPtrRef = entry.meta;
+    std::shared_ptr<CreationException>& insertedException = entry.exception;
+
+    this->beginCreation(entry);
+    std::shared_ptr<CreationException> exception;
+    if (const clang::FunctionDecl* function = clang::dyn_cast<clang::FunctionDecl>(&decl)) {
+        exception = this->createMeta<FunctionMeta>(*function, insertedMetaPtrRef, &MetaFactory::createFromFunction);
+    } else if (const clang::RecordDecl* record = clang::dyn_cast<clang::RecordDecl>(&decl)) {
+        if (record->isStruct()) {
+            exception = this->createMeta<StructMeta>(*record, insertedMetaPtrRef, &MetaFactory::createFromStruct);
         } else {
-            throw logic_error("Unknown declaration type.");
+            exception = resetMetaAndAddToMap<UnionMeta>(insertedMetaPtrRef, this->_metaToDecl, decl);
+            if (!exception) {
+                exception = populateIdentificationFields(*record, *insertedMetaPtrRef.get());
+            }
+            if (!exception) {
+                exception = std::make_shared<MetaCreationException>(insertedMetaPtrRef.get(), "The record is union.", false);
+            }
         }
+    } else if (const clang::VarDecl* var = clang::dyn_cast<clang::VarDecl>(&decl)) {
+        exception = this->createMeta<VarMeta>(*var, insertedMetaPtrRef, &MetaFactory::createFromVar);
+    } else if (const clang::EnumDecl* enumDecl = clang::dyn_cast<clang::EnumDecl>(&decl)) {
+        exception = this->createMeta<EnumMeta>(*enumDecl, insertedMetaPtrRef, &MetaFactory::createFromEnum);
+    } else if (const clang::EnumConstantDecl* enumConstantDecl = clang::dyn_cast<clang::EnumConstantDecl>(&decl)) {
+        exception = this->createMeta<EnumConstantMeta>(*enumConstantDecl, insertedMetaPtrRef, &MetaFactory::createFromEnumConstant);
+    } else if (const clang::ObjCInterfaceDecl* interface = clang::dyn_cast<clang::ObjCInterfaceDecl>(&decl)) {
+        exception = this->createMeta<InterfaceMeta>(*interface, insertedMetaPtrRef, &MetaFactory::createFromInterface);
+    } else if (const clang::ObjCProtocolDecl* protocol = clang::dyn_cast<clang::ObjCProtocolDecl>(&decl)) {
+        exception = this->createMeta<ProtocolMeta>(*protocol, insertedMetaPtrRef, &MetaFactory::createFromProtocol);
+    } else if (const clang::ObjCCategoryDecl* category = clang::dyn_cast<clang::ObjCCategoryDecl>(&decl)) {
+        exception = this->createMeta<CategoryMeta>(*category, insertedMetaPtrRef, &MetaFactory::createFromCategory);
+    } else if (const clang::ObjCMethodDecl* method = clang::dyn_cast<clang::ObjCMethodDecl>(&decl)) {
+        exception = this->createMeta<MethodMeta>(*method, insertedMetaPtrRef, &MetaFactory::createFromMethod);
+    } else if (const clang::ObjCPropertyDecl* property = clang::dyn_cast<clang::ObjCPropertyDecl>(&decl)) {
+        exception = this->createMeta<PropertyMeta>(*property, insertedMetaPtrRef, &MetaFactory::createFromProperty);
+    } else {
+        throw logic_error("Unknown declaration type.");
+    }
 
+    this->endCreation(entry, /*succeeded*/ exception == nullptr);
+    if (exception == nullptr) {
         return insertedMetaPtrRef.get();
-    } catch (MetaCreationException& e) {
-        if (e.getMeta() == insertedMetaPtrRef.get()) {
-            insertedException = llvm::make_unique<MetaCreationException>(e);
-            throw;
+    }
+
+    const MetaCreationException* metaException = llvm::dyn_cast<MetaCreationException>(exception.get());
+    if (metaException != nullptr && metaException->getMeta() == insertedMetaPtrRef.get()) {
+        insertedException = exception;
+    } else {
+        const char* message = (metaException != nullptr) ? "Can't create meta dependency." : "Can't create type dependency.";
+        insertedException = std::make_shared<MetaCreationException>(insertedMetaPtrRef.get(), message, exception->isError(), exception);
+    }
+    this->_validationGeneration++;
+    return insertedException;
+}
+
+void MetaFactory::beginCreation(MetaCacheEntry& entry)
+{
+    entry.creationStackIndex = (int)this->_creationStack.size();
+    this->_creationStack.push_back(CreationFrame{ &entry, entry.creationStackIndex });
+}
+
+void MetaFactory::endCreation(MetaCacheEntry& entry, bool succeeded)
+{
+    assert(!this->_creationStack.empty() && this->_creationStack.back().entry == &entry);
+    int lowestPendingIndex = this->_creationStack.back().lowestPendingIndex;
+    this->_creationStack.pop_back();
+
+    // A failure is final, but a success is only final if all of the used metas were complete
+    if (succeeded && lowestPendingIndex < entry.creationStackIndex) {
+        entry.pendingDependency = this->_creationStack[lowestPendingIndex].entry;
+        this->registerPendingDependency(lowestPendingIndex);
+    } else {
+        entry.pendingDependency = nullptr;
+    }
+    entry.creationStackIndex = -1;
+}
+
+int MetaFactory::getPendingCreationIndex(const MetaCacheEntry& entry)
+{
+    for (const MetaCacheEntry* current = &entry; current != nullptr; current = current->pendingDependency) {
+        if (current->creationStackIndex >= 0) {
+            return current->creationStackIndex;
         }
-        std::string message = CreationException::constructMessage("Can't create meta dependency.", e.getDetailedMessage());
-        insertedException = llvm::make_unique<MetaCreationException>(insertedMetaPtrRef.get(), message, e.isError());
-        POLYMORPHIC_THROW(insertedException);
-    } catch (TypeCreationException& e) {
-        std::string message = CreationException::constructMessage("Can't create type dependency.", e.getDetailedMessage());
-        insertedException = llvm::make_unique<MetaCreationException>(insertedMetaPtrRef.get(), message, e.isError());
-        POLYMORPHIC_THROW(insertedException);
+    }
+    return -1;
+}
+
+void MetaFactory::registerPendingDependency(int creationStackIndex)
+{
+    this->_pendingDependencyCount++;
+    if (!this->_creationStack.empty()) {
+        CreationFrame& frame = this->_creationStack.back();
+        frame.lowestPendingIndex = std::min(frame.lowestPendingIndex, creationStackIndex);
     }
 }
 
 bool MetaFactory::tryCreate(const clang::Decl& decl, Meta** meta)
 {
-    try {
-        Meta* result = this->create(decl);
-        if (meta != nullptr) {
-            *meta = result;
-        }
-        return true;
-    } catch (CreationException& e) {
+    CreationResult<Meta*> result = this->create(decl);
+    if (!result) {
         return false;
     }
+    if (meta != nullptr) {
+        *meta = result.getValue();
+    }
+    return true;
 }
 
-void MetaFactory::createFromFunction(const clang::FunctionDecl& function, FunctionMeta& functionMeta)
+void MetaFactory::freeze()
+{
+    // The metas created by the filters which are still pending are kept as they are
+    for (Cache::value_type& entry : this->_cache) {
+        entry.second.pendingDependency = nullptr;
+    }
+    this->_isFrozen = true;
+}
+
+std::vector<Meta*> MetaFactory::settlePendingMetas()
+{
+    assert(this->_creationStack.empty());
+    std::vector<Meta*> invalidMetas;
+    std::vector<const clang::Decl*> pendingDecls;
+    do {
+        // Creating a meta again may leave some of its dependencies pending on it, so this is repeated until none are left.
+        // Each pass settles at least the metas which are created at the top of the creation stack.
+        pendingDecls.clear();
+        for (const Cache::value_type& entry : this->_cache) {
+            if (entry.second.pendingDependency != nullptr) {
+                pendingDecls.push_back(entry.first);
+            }
+        }
+
+        for (const clang::Decl* decl : pendingDecls) {
+            CreationResult<Meta*> result = this->create(*decl);
+            if (!result) {
+                invalidMetas.push_back(this->_cache[decl].meta.get());
+            }
+        }
+    } while (!pendingDecls.empty());
+    return invalidMetas;
+}
+
+std::shared_ptr<CreationException> MetaFactory::createFromFunction(const clang::FunctionDecl& function, FunctionMeta& functionMeta)
 {
     if (function.isThisDeclarationADefinition()) {
-        throw MetaCreationException(&functionMeta, "The function is defined in headers.", false);
+        return std::make_shared<MetaCreationException>(&functionMeta, "The function is defined in headers.", false);
     }
 
     // TODO: We don't support variadic functions but we save in metadata flags whether a function is variadic or not.
     // If we not plan in the future to support variadic functions this redundant flag should be removed.
     if (function.isVariadic())
-        throw MetaCreationException(&functionMeta, "The function is variadic.", false);
+        return std::make_shared<MetaCreationException>(&functionMeta, "The function is variadic.", false);
 
-    populateMetaFields(function, functionMeta);
+    if (auto exception = populateMetaFields(function, functionMeta)) {
+        return exception;
+    }
 
     functionMeta.setFlags(MetaFlags::FunctionIsVariadic, function.isVariadic()); // set IsVariadic
 
     // set signature
-    functionMeta.signature.push_back(_typeFactory.create(function.getReturnType()).get());
+    CreationResult<shared_ptr<Type>> returnType = _typeFactory.create(function.getReturnType());
+    RETURN_IF_FAILED(returnType);
+    functionMeta.signature.push_back(returnType.getValue().get());
     for (clang::ParmVarDecl* param : function.parameters()) {
-        functionMeta.signature.push_back(_typeFactory.create(param->getType()).get());
+        CreationResult<shared_ptr<Type>> paramType = _typeFactory.create(param->getType());
+        RETURN_IF_FAILED(paramType);
+        functionMeta.signature.push_back(paramType.getValue().get());
     }
 
     bool returnsRetained = function.hasAttr<clang::NSReturnsRetainedAttr>() || function.hasAttr<clang::CFReturnsRetainedAttr>();
@@ -230,40 +327,50 @@ void MetaFactory::createFromFunction(const clang::FunctionDecl& function, Functi
     }
 
     functionMeta.setFlags(MetaFlags::FunctionOwnsReturnedCocoaObject, returnsRetained); // set OwnsReturnedCocoaObjects
+    return nullptr;
 }
 
-void MetaFactory::createFromStruct(const clang::RecordDecl& record, StructMeta& structMeta)
+std::shared_ptr<CreationException> MetaFactory::createFromStruct(const clang::RecordDecl& record, StructMeta& structMeta)
 {
     if (!record.isStruct())
-        throw MetaCreationException(&structMeta, "The record is not a struct.", false);
+        return std::make_shared<MetaCreationException>(&structMeta, "The record is not a struct.", false);
     if (!record.isThisDeclarationADefinition()) {
-        throw MetaCreationException(&structMeta, "A forward declaration of record.", false);
+        return std::make_shared<MetaCreationException>(&structMeta, "A forward declaration of record.", false);
     }
 
-    populateMetaFields(record, structMeta);
+    if (auto exception = populateMetaFields(record, structMeta)) {
+        return exception;
+    }
 
     // set fields
     for (clang::FieldDecl* field : record.fields()) {
-        RecordField recordField(field->getNameAsString(), _typeFactory.create(field->getType()).get());
+        CreationResult<shared_ptr<Type>> fieldType = _typeFactory.create(field->getType());
+        RETURN_IF_FAILED(fieldType);
+        RecordField recordField(field->getNameAsString(), fieldType.getValue().get());
         structMeta.fields.push_back(recordField);
     }
+    return nullptr;
 }
 
-void MetaFactory::createFromVar(const clang::VarDecl& var, VarMeta& varMeta)
+std::shared_ptr<CreationException> MetaFactory::createFromVar(const clang::VarDecl& var, VarMeta& varMeta)
 {
     if (var.getLexicalDeclContext() != var.getASTContext().getTranslationUnitDecl()) {
-        throw MetaCreationException(&varMeta, "A nested var.", false);
+        return std::make_shared<MetaCreationException>(&varMeta, "A nested var.", false);
     }
 
-    populateMetaFields(var, varMeta);
+    if (auto exception = populateMetaFields(var, varMeta)) {
+        return exception;
+    }
     //set type
-    varMeta.signature = _typeFactory.create(var.getType()).get();
+    CreationResult<shared_ptr<Type>> varType = _typeFactory.create(var.getType());
+    RETURN_IF_FAILED(varType);
+    varMeta.signature = varType.getValue().get();
     varMeta.hasValue = false;
 
     if (var.hasInit()) {
         clang::APValue* evValue = var.evaluateValue();
         if (evValue == nullptr) {
-            throw MetaCreationException(&varMeta, "Unable to evaluate compile-time constant value.", false);
+            return std::make_shared<MetaCreationException>(&varMeta, "Unable to evaluate compile-time constant value.", false);
         }
 
         varMeta.hasValue = true;
@@ -277,40 +384,43 @@ void MetaFactory::createFromVar(const clang::VarDecl& var, VarMeta& varMeta)
             evValue->getFloat().toString(valueAsString);
             break;
         case clang::APValue::ValueKind::ComplexInt:
-            throw MetaCreationException(&varMeta, "Not supported compile-time constant value: ComplexInt.", false);
+            return std::make_shared<MetaCreationException>(&varMeta, "Not supported compile-time constant value: ComplexInt.", false);
         case clang::APValue::ValueKind::ComplexFloat:
-            throw MetaCreationException(&varMeta, "Not supported compile-time constant value: ComplexFloat.", false);
+            return std::make_shared<MetaCreationException>(&varMeta, "Not supported compile-time constant value: ComplexFloat.", false);
         case clang::APValue::ValueKind::AddrLabelDiff:
-            throw MetaCreationException(&varMeta, "Not supported compile-time constant value: AddrLabelDiff.", false);
+            return std::make_shared<MetaCreationException>(&varMeta, "Not supported compile-time constant value: AddrLabelDiff.", false);
         case clang::APValue::ValueKind::Array:
-            throw MetaCreationException(&varMeta, "Not supported compile-time constant value: Array.", false);
+            return std::make_shared<MetaCreationException>(&varMeta, "Not supported compile-time constant value: Array.", false);
         case clang::APValue::ValueKind::LValue:
-            throw MetaCreationException(&varMeta, "Not supported compile-time constant value: LValue.", false);
+            return std::make_shared<MetaCreationException>(&varMeta, "Not supported compile-time constant value: LValue.", false);
         case clang::APValue::ValueKind::MemberPointer:
-            throw MetaCreationException(&varMeta, "Not supported compile-time constant value: MemberPointer.", false);
+            return std::make_shared<MetaCreationException>(&varMeta, "Not supported compile-time constant value: MemberPointer.", false);
         case clang::APValue::ValueKind::Struct:
-            throw MetaCreationException(&varMeta, "Not supported compile-time constant value: Struct.", false);
+            return std::make_shared<MetaCreationException>(&varMeta, "Not supported compile-time constant value: Struct.", false);
         case clang::APValue::ValueKind::Union:
-            throw MetaCreationException(&varMeta, "Not supported compile-time constant value: Union.", false);
+            return std::make_shared<MetaCreationException>(&varMeta, "Not supported compile-time constant value: Union.", false);
         case clang::APValue::ValueKind::Vector:
-            throw MetaCreationException(&varMeta, "Not supported compile-time constant value: Vector.", false);
+            return std::make_shared<MetaCreationException>(&varMeta, "Not supported compile-time constant value: Vector.", false);
         case clang::APValue::ValueKind::Uninitialized:
-            throw MetaCreationException(&varMeta, "Not supported compile-time constant value: Uninitialized.", false);
+            return std::make_shared<MetaCreationException>(&varMeta, "Not supported compile-time constant value: Uninitialized.", false);
         default:
-            throw MetaCreationException(&varMeta, "Not supported compile-time constant value: -.", false);
+            return std::make_shared<MetaCreationException>(&varMeta, "Not supported compile-time constant value: -.", false);
         }
 
         varMeta.value = std::string(valueAsString.data(), valueAsString.size());
     }
+    return nullptr;
 }
 
-void MetaFactory::createFromEnum(const clang::EnumDecl& enumeration, EnumMeta& enumMeta)
+std::shared_ptr<CreationException> MetaFactory::createFromEnum(const clang::EnumDecl& enumeration, EnumMeta& enumMeta)
 {
     if (!enumeration.isThisDeclarationADefinition()) {
-        throw MetaCreationException(&enumMeta, "Forward declaration of enum.", false);
+        return std::make_shared<MetaCreationException>(&enumMeta, "Forward declaration of enum.", false);
     }
 
-    populateMetaFields(enumeration, enumMeta);
+    if (auto exception = populateMetaFields(enumeration, enumMeta)) {
+        return exception;
+    }
 
     std::vector<std::string> fieldNames;
     for (clang::EnumConstantDecl* enumField : enumeration.enumerators())
@@ -329,55 +439,77 @@ void MetaFactory::createFromEnum(const clang::EnumDecl& enumeration, EnumMeta& e
         }
         enumMeta.fullNameFields.push_back({ enumField->getNameAsString(), valueStr });
     }
+    return nullptr;
 }
 
-void MetaFactory::createFromEnumConstant(const clang::EnumConstantDecl& enumConstant, EnumConstantMeta& enumConstantMeta)
+std::shared_ptr<CreationException> MetaFactory::createFromEnumConstant(const clang::EnumConstantDecl& enumConstant, EnumConstantMeta& enumConstantMeta)
 {
-    populateMetaFields(enumConstant, enumConstantMeta);
+    if (auto exception = populateMetaFields(enumConstant, enumConstantMeta)) {
+        return exception;
+    }
 
     llvm::SmallVector<char, 10> value;
     enumConstant.getInitVal().toString(value, 10, enumConstant.getInitVal().isSigned());
     enumConstantMeta.value = std::string(value.data(), value.size());
 
     const clang::EnumDecl* parent = clang::cast<clang::EnumDecl>(enumConstant.getDeclContext());
-    EnumMeta& parentMeta = this->_cache.find(parent)->second.first.get()->as<EnumMeta>();
+    EnumMeta& parentMeta = this->_cache.find(parent)->second.meta.get()->as<EnumMeta>();
     enumConstantMeta.isScoped = !parentMeta.jsName.empty();
+    return nullptr;
 }
 
-void MetaFactory::createFromInterface(const clang::ObjCInterfaceDecl& interface, InterfaceMeta& interfaceMeta)
+std::shared_ptr<CreationException> MetaFactory::createFromInterface(const clang::ObjCInterfaceDecl& interface, InterfaceMeta& interfaceMeta)
 {
     if (!interface.isThisDeclarationADefinition()) {
-        throw MetaCreationException(&interfaceMeta, "A forward declaration of interface.", false);
+        return std::make_shared<MetaCreationException>(&interfaceMeta, "A forward declaration of interface.", false);
     }
 
-    populateMetaFields(interface, interfaceMeta);
+    if (auto exception = populateMetaFields(interface, interfaceMeta)) {
+        return exception;
+    }
     populateBaseClassMetaFields(interface, interfaceMeta);
 
     // set base interface
     clang::ObjCInterfaceDecl* super = interface.getSuperClass();
-    interfaceMeta.base = (super == nullptr || super->getDefinition() == nullptr) ? nullptr : &this->create(*super->getDefinition())->as<InterfaceMeta>();
+    interfaceMeta.base = nullptr;
+    if (super != nullptr && super->getDefinition() != nullptr) {
+        CreationResult<Meta*> base = this->create(*super->getDefinition());
+        RETURN_IF_FAILED(base);
+        interfaceMeta.base = &base.getValue()->as<InterfaceMeta>();
+    }
+    return nullptr;
 }
 
-void MetaFactory::createFromProtocol(const clang::ObjCProtocolDecl& protocol, ProtocolMeta& protocolMeta)
+std::shared_ptr<CreationException> MetaFactory::createFromProtocol(const clang::ObjCProtocolDecl& protocol, ProtocolMeta& protocolMeta)
 {
     if (!protocol.isThisDeclarationADefinition()) {
-        throw MetaCreationException(&protocolMeta, "A forward declaration of protocol.", false);
+        return std::make_shared<MetaCreationException>(&protocolMeta, "A forward declaration of protocol.", false);
     }
 
-    populateMetaFields(protocol, protocolMeta);
+    if (auto exception = populateMetaFields(protocol, protocolMeta)) {
+        return exception;
+    }
     populateBaseClassMetaFields(protocol, protocolMeta);
+    return nullptr;
 }
 
-void MetaFactory::createFromCategory(const clang::ObjCCategoryDecl& category, CategoryMeta& categoryMeta)
+std::shared_ptr<CreationException> MetaFactory::createFromCategory(const clang::ObjCCategoryDecl& category, CategoryMeta& categoryMeta)
 {
-    populateMetaFields(category, categoryMeta);
+    if (auto exception = populateMetaFields(category, categoryMeta)) {
+        return exception;
+    }
     populateBaseClassMetaFields(category, categoryMeta);
-    categoryMeta.extendedInterface = &this->create(*category.getClassInterface()->getDefinition())->as<InterfaceMeta>();
+    CreationResult<Meta*> extendedInterface = this->create(*category.getClassInterface()->getDefinition());
+    RETURN_IF_FAILED(extendedInterface);
+    categoryMeta.extendedInterface = &extendedInterface.getValue()->as<InterfaceMeta>();
+    return nullptr;
 }
 
-void MetaFactory::createFromMethod(const clang::ObjCMethodDecl& method, MethodMeta& methodMeta)
+std::shared_ptr<CreationException> MetaFactory::createFromMethod(const clang::ObjCMethodDecl& method, MethodMeta& methodMeta)
 {
-    populateMetaFields(method, methodMeta);
+    if (auto exception = populateMetaFields(method, methodMeta)) {
+        return exception;
+    }
     
     methodMeta.setFlags(MetaFlags::MemberIsOptional, method.isOptional());
     methodMeta.setFlags(MetaFlags::MethodIsVariadic, method.isVariadic()); // set IsVariadic flag
@@ -388,7 +520,9 @@ void MetaFactory::createFromMethod(const clang::ObjCMethodDecl& method, MethodMe
     // set MethodHasErrorOutParameter flag
     if (method.parameters().size() > 0) {
         clang::ParmVarDecl* lastParameter = method.parameters()[method.parameters().size() - 1];
-        Type* type = _typeFactory.create(lastParameter->getType()).get();
+        CreationResult<shared_ptr<Type>> lastParameterType = _typeFactory.create(lastParameter->getType());
+        RETURN_IF_FAILED(lastParameterType);
+        Type* type = lastParameterType.getValue().get();
         if (type->is(TypeType::TypePointer)) {
             Type* innerType = type->as<PointerType>().innerType;
             if (innerType->is(TypeType::TypeInterface) && innerType->as<InterfaceType>().interface->jsName == "NSError") {
@@ -443,7 +577,7 @@ void MetaFactory::createFromMethod(const clang::ObjCMethodDecl& method, MethodMe
     }
 
     if (method.isVariadic() && !isNullTerminatedVariadic)
-        throw MetaCreationException(&methodMeta, "Method is variadic (and is not marked as nil terminated.).", false);
+        return std::make_shared<MetaCreationException>(&methodMeta, "Method is variadic (and is not marked as nil terminated.).", false);
 
     // set MethodOwnsReturnedCocoaObject flag
     clang::ObjCMethodFamily methodFamily = method.getMethodFamily();
@@ -467,23 +601,43 @@ void MetaFactory::createFromMethod(const clang::ObjCMethodDecl& method, MethodMe
     }
 
     // set signature
-    methodMeta.signature.push_back(method.hasRelatedResultType() ? _typeFactory.getInstancetype().get() : _typeFactory.create(method.getReturnType()).get());
+    if (method.hasRelatedResultType()) {
+        methodMeta.signature.push_back(_typeFactory.getInstancetype().get());
+    } else {
+        CreationResult<shared_ptr<Type>> returnType = _typeFactory.create(method.getReturnType());
+        RETURN_IF_FAILED(returnType);
+        methodMeta.signature.push_back(returnType.getValue().get());
+    }
     for (clang::ParmVarDecl* param : method.parameters()) {
-        methodMeta.signature.push_back(_typeFactory.create(param->getType()).get());
+        CreationResult<shared_ptr<Type>> paramType = _typeFactory.create(param->getType());
+        RETURN_IF_FAILED(paramType);
+        methodMeta.signature.push_back(paramType.getValue().get());
     }
+    return nullptr;
 }
 
-void MetaFactory::createFromProperty(const clang::ObjCPropertyDecl& property, PropertyMeta& propertyMeta)
+std::shared_ptr<CreationException> MetaFactory::createFromProperty(const clang::ObjCPropertyDecl& property, PropertyMeta& propertyMeta)
 {
-    populateMetaFields(property, propertyMeta);
+    if (auto exception = populateMetaFields(property, propertyMeta)) {
+        return exception;
+    }
 
     propertyMeta.setFlags(MetaFlags::MemberIsOptional, property.isOptional());
 
-    clang::ObjCMethodDecl* getter = property.getGetterMethodDecl();
-    propertyMeta.getter = getter ? &create(*getter)->as<MethodMeta>() : nullptr;
+    propertyMeta.getter = nullptr;
+    if (clang::ObjCMethodDecl* getter = property.getGetterMethodDecl()) {
+        CreationResult<Meta*> getterMeta = create(*getter);
+        RETURN_IF_FAILED(getterMeta);
+        propertyMeta.getter = &getterMeta.getValue()->as<MethodMeta>();
+    }
 
-    clang::ObjCMethodDecl* setter = property.getSetterMethodDecl();
-    propertyMeta.setter = setter ? &create(*setter)->as<MethodMeta>() : nullptr;
+    propertyMeta.setter = nullptr;
+    if (clang::ObjCMethodDecl* setter = property.getSetterMethodDecl()) {
+        CreationResult<Meta*> setterMeta = create(*setter);
+        RETURN_IF_FAILED(setterMeta);
+        propertyMeta.setter = &setterMeta.getValue()->as<MethodMeta>();
+    }
+    return nullptr;
 }
 
 
@@ -514,7 +668,7 @@ std::string demangleSwiftName(std::string name) {
     return result;
 }
 
-void MetaFactory::populateIdentificationFields(const clang::NamedDecl& decl, Meta& meta)
+std::shared_ptr<CreationException> MetaFactory::populateIdentificationFields(const clang::NamedDecl& decl, Meta& meta)
 {
     meta.declaration = &decl;
     // calculate name
@@ -575,23 +729,24 @@ void MetaFactory::populateIdentificationFields(const clang::NamedDecl& decl, Met
     // because we don't keep them as separate entity in metadata. They are merged in their interfaces
     if (!meta.is(MetaType::Category)) {
         if (meta.fileName == "") {
-            throw MetaCreationException(&meta, "Unknown file for declaration.", true);
+            return std::make_shared<MetaCreationException>(&meta, "Unknown file for declaration.", true);
         } else if (meta.module == nullptr) {
-            throw MetaCreationException(&meta, "Unknown module for declaration.", false);
+            return std::make_shared<MetaCreationException>(&meta, "Unknown module for declaration.", false);
         } else if (meta.jsName == "") {
-            throw MetaCreationException(&meta, "Anonymous declaration. Unable to calculate JS name.", false);
+            return std::make_shared<MetaCreationException>(&meta, "Anonymous declaration. Unable to calculate JS name.", false);
         }
     }
+    return nullptr;
 }
 
-void MetaFactory::populateMetaFields(const clang::NamedDecl& decl, Meta& meta)
+std::shared_ptr<CreationException> MetaFactory::populateMetaFields(const clang::NamedDecl& decl, Meta& meta)
 {
     clang::AvailabilityAttr* iosAvailability = nullptr;
     clang::AvailabilityAttr* iosExtensionsAvailability = nullptr;
 
     // Traverse attributes
     if (decl.hasAttr<clang::UnavailableAttr>()) {
-        throw MetaCreationException(&meta, "The declaration is marked unavailable (with unavailable attribute).", false);
+        return std::make_shared<MetaCreationException>(&meta, "The declaration is marked unavailable (with unavailable attribute).", false);
     }
     vector<clang::AvailabilityAttr*> availabilityAttributes = Utils::getAttributes<clang::AvailabilityAttr>(decl);
     for (clang::AvailabilityAttr* availability : availabilityAttributes) {
@@ -619,7 +774,7 @@ void MetaFactory::populateMetaFields(const clang::NamedDecl& decl, Meta& meta)
          */
     if (iosAvailability) {
         if (iosAvailability->getUnavailable()) {
-            throw MetaCreationException(&meta, "The declaration is marked unvailable for ios platform (with availability attribute).", false);
+            return std::make_shared<MetaCreationException>(&meta, "The declaration is marked unvailable for ios platform (with availability attribute).", false);
         }
         meta.introducedIn = this->convertVersion(iosAvailability->getIntroduced());
         meta.deprecatedIn = this->convertVersion(iosAvailability->getDeprecated());
@@ -627,6 +782,7 @@ void MetaFactory::populateMetaFields(const clang::NamedDecl& decl, Meta& meta)
     }
     bool isIosExtensionsAvailable = iosExtensionsAvailability == nullptr || !iosExtensionsAvailability->getUnavailable();
     meta.setFlags(MetaFlags::IsIosAppExtensionAvailable, isIosExtensionsAvailable);
+    return nullptr;
 }
 
 void MetaFactory::populateBaseClassMetaFields(const clang::ObjCContainerDecl& decl, BaseClassMeta& baseClass)
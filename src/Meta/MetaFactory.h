@@ -11,7 +11,17 @@
 
 namespace Meta {
 
-typedef std::unordered_map<const clang::Decl*, std::pair<std::unique_ptr<Meta>, std::unique_ptr<CreationException>> > Cache;
+struct MetaCacheEntry {
+    std::unique_ptr<Meta> meta;
+    std::shared_ptr<CreationException> exception;
+    // Position in the creation stack while the meta is being created, -1 otherwise.
+    int creationStackIndex = -1;
+    // Set if the meta has been completed while a meta it depends on was still being created.
+    // Such a meta is created again on its next use after that dependency is complete, or at the end of the conversion.
+    const MetaCacheEntry* pendingDependency = nullptr;
+};
+
+typedef std::unordered_map<const clang::Decl*, MetaCacheEntry> Cache;
 typedef std::unordered_map<const Meta*, const clang::Decl*> MetaToDeclMap;
 
 class MetaFactory {
@@ -23,10 +33,17 @@ public:
     {
     }
 
-    Meta* create(const clang::Decl& decl, bool resetCached = false);
+    CreationResult<Meta*> create(const clang::Decl& decl);
 
     bool tryCreate(const clang::Decl& decl, Meta** meta);
 
+    // Creates again all metas which have been completed while one of their dependencies was still being created, so that
+    // none of them is created again later (e.g. after the filters have changed it). Returns the ones which have turned out invalid.
+    std::vector<Meta*> settlePendingMetas();
+
+    // Called once the filters have run. The metas are final from then on, so any later request is served from the cache.
+    void freeze();
+
     TypeFactory& getTypeFactory()
     {
         return this->_typeFactory;
@@ -37,38 +54,68 @@ public:
         return this->_cache;
     }
     
-    void validate(Type* type);
+    std::shared_ptr<CreationException> validate(Type* type);
+
+    std::shared_ptr<CreationException> validate(Meta* meta);
+
+    // Incremented each time a meta fails to be created. Validation results obtained
+    // within the same generation remain valid.
+    unsigned getValidationGeneration() const
+    {
+        return this->_validationGeneration;
+    }
 
-    void validate(Meta* meta);
+    // Incremented each time a meta is used while it (or a meta it depends on) is still being created.
+    unsigned getPendingDependencyCount() const
+    {
+        return this->_pendingDependencyCount;
+    }
     
     static std::string getTypedefOrOwnName(const clang::TagDecl* tagDecl);
     
     static std::string renameMeta(MetaType type, std::string& originalJsName, int index = 1);
 
 private:
-    void createFromFunction(const clang::FunctionDecl& function, FunctionMeta& functionMeta);
+    struct CreationFrame {
+        MetaCacheEntry* entry;
+        // The lowest creation stack index of a meta which has been used before being complete
+        int lowestPendingIndex;
+    };
+
+    template <class TMeta, class TDecl>
+    std::shared_ptr<CreationException> createMeta(const TDecl& decl, std::unique_ptr<Meta>& metaPtrRef, std::shared_ptr<CreationException> (MetaFactory::*createFrom)(const TDecl&, TMeta&));
+
+    void beginCreation(MetaCacheEntry& entry);
+
+    void endCreation(MetaCacheEntry& entry, bool succeeded);
+
+    int getPendingCreationIndex(const MetaCacheEntry& entry);
+
+    void registerPendingDependency(int creationStackIndex);
+
+    std::shared_ptr<CreationException> createFromFunction(const clang::FunctionDecl& function, FunctionMeta& functionMeta);
 
-    void createFromStruct(const clang::RecordDecl& record, StructMeta& recordMeta);
+    std::shared_ptr<CreationException> createFromStruct(const clang::RecordDecl& record, StructMeta& recordMeta);
 
-    void createFromVar(const clang::VarDecl& var, VarMeta& varMeta);
+    std::shared_ptr<CreationException> createFromVar(const clang::VarDecl& var, VarMeta& varMeta);
 
-    void createFromEnum(const clang::EnumDecl& enumeration, EnumMeta& enumMeta);
+    std::shared_ptr<CreationException> createFromEnum(const clang::EnumDecl& enumeration, EnumMeta& enumMeta);
 
-    void createFromEnumConstant(const clang::EnumConstantDecl& enumConstant, EnumConstantMeta& enumMeta);
+    std::shared_ptr<CreationException> createFromEnumConstant(const clang::EnumConstantDecl& enumConstant, EnumConstantMeta& enumMeta);
 
-    void createFromInterface(const clang::ObjCInterfaceDecl& interface, InterfaceMeta& interfaceMeta);
+    std::shared_ptr<CreationException> createFromInterface(const clang::ObjCInterfaceDecl& interface, InterfaceMeta& interfaceMeta);
 
-    void createFromProtocol(const clang::ObjCProtocolDecl& protocol, ProtocolMeta& protocolMeta);
+    std::shared_ptr<CreationException> createFromProtocol(const clang::ObjCProtocolDecl& protocol, ProtocolMeta& protocolMeta);
 
-    void createFromCategory(const clang::ObjCCategoryDecl& category, CategoryMeta& categoryMeta);
+    std::shared_ptr<CreationException> createFromCategory(const clang::ObjCCategoryDecl& category, CategoryMeta& categoryMeta);
 
-    void createFromMethod(const clang::ObjCMethodDecl& method, MethodMeta& methodMeta);
+    std::shared_ptr<CreationException> createFromMethod(const clang::ObjCMethodDecl& method, MethodMeta& methodMeta);
 
-    void createFromProperty(const clang::ObjCPropertyDecl& property, PropertyMeta& propertyMeta);
+    std::shared_ptr<CreationException> createFromProperty(const clang::ObjCPropertyDecl& property, PropertyMeta& propertyMeta);
 
-    void populateIdentificationFields(const clang::NamedDecl& decl, Meta& meta);
+    std::shared_ptr<CreationException> populateIdentificationFields(const clang::NamedDecl& decl, Meta& meta);
 
-    void populateMetaFields(const clang::NamedDecl& decl, Meta& meta);
+    std::shared_ptr<CreationException> populateMetaFields(const clang::NamedDecl& decl, Meta& meta);
 
     void populateBaseClassMetaFields(const clang::ObjCContainerDecl& decl, BaseClassMeta& baseClassMeta);
 
@@ -82,5 +129,9 @@ private:
 
     Cache _cache;
     MetaToDeclMap _metaToDecl;
+    unsigned _validationGeneration = 1;
+    std::vector<CreationFrame> _creationStack;
+    unsigned _pendingDependencyCount = 0;
+    bool _isFrozen = false;
 };
 }
@@ -0,0 +1,40 @@
+#include "SymbolIndex.h"
+#include <algorithm>
+
+namespace Meta {
+static bool compareEntries(const SymbolIndex::Entry& first, const SymbolIndex::Entry& second)
+{
+    return first.first < second.first;
+}
+
+SymbolIndex::SymbolIndex(const MetaContainer& container)
+{
+    for (size_t type = 0; type < MetaTypesCount; type++) {
+        std::vector<Entry>& entries = _entriesByType[type];
+        for (Meta* meta : container.ofType(static_cast<MetaType>(type))) {
+            entries.push_back(Entry(meta->name, meta));
+        }
+        // Keep metas with the same name in container order
+        std::stable_sort(entries.begin(), entries.end(), compareEntries);
+    }
+}
+
+std::pair<SymbolIndex::const_iterator, SymbolIndex::const_iterator> SymbolIndex::getMetas(MetaType type, llvm::StringRef name) const
+{
+    const std::vector<Entry>& entries = _entriesByType[type];
+    return std::equal_range(entries.begin(), entries.end(), Entry(name, nullptr), compareEntries);
+}
+
+Meta* SymbolIndex::find(MetaType type, llvm::StringRef name, const std::string& fullModuleName) const
+{
+    std::pair<const_iterator, const_iterator> range = getMetas(type, name);
+    for (const_iterator it = range.first; it != range.second; ++it) {
+        // Module names are only built for the few metas which have the requested name
+        Meta* meta = it->second;
+        if (meta->module != nullptr && meta->module->getFullModuleName() == fullModuleName) {
+            return meta;
+        }
+    }
+    return nullptr;
+}
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "MetaContainer.h"
+#include "MetaEntities.h"
+#include <llvm/ADT/StringRef.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Meta {
+/*
+ * \class SymbolIndex
+ * \brief Indexes the converted metas by type and name so that filters which look for specific symbols
+ * don't have to scan the whole meta container.
+ *
+ * The index is built once after the declarations have been converted and is shared by all filters.
+ * The keys refer to the names of the metas, which are not changed after conversion. Metas removed
+ * from the container by a filter are not removed from the index.
+ */
+class SymbolIndex {
+public:
+    typedef std::pair<llvm::StringRef, Meta*> Entry;
+    typedef std::vector<Entry>::const_iterator const_iterator;
+
+    explicit SymbolIndex(const MetaContainer& container);
+
+    // The metas with the given type and name in the order in which they appear in the container
+    std::pair<const_iterator, const_iterator> getMetas(MetaType type, llvm::StringRef name) const;
+
+    // Returns the first meta with the given type, name and full module name or nullptr if there is none.
+    Meta* find(MetaType type, llvm::StringRef name, const std::string& fullModuleName) const;
+
+private:
+    static const size_t MetaTypesCount = MetaType::EnumConstant + 1;
+
+    // Sorted by name
+    std::vector<Entry> _entriesByType[MetaTypesCount];
+};
+}
@@ -3,17 +3,66 @@
 #include "MetaFactory.h"
 #include "Utils.h"
 #include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/StringMap.h>
 
 namespace Meta {
 using namespace std;
 
-static const std::vector<std::string> KNOWN_BRIDGED_TYPES = {
-#define CF_TYPE(NAME) #NAME,
+// Typedefs which are handled specially when they appear anywhere in a typedef chain.
+// The order of the enumerators is the order in which they take precedence.
+enum class SpecialTypedefKind {
+    Bool,
+    Unichar,
+    VaList,
+    KnownBridged,
+    None
+};
+
+static const llvm::StringMap<SpecialTypedefKind>& getSpecialTypedefs()
+{
+    static const llvm::StringMap<SpecialTypedefKind> specialTypedefs = []() {
+        llvm::StringMap<SpecialTypedefKind> typedefs;
+        for (const char* name : { "BOOL", "Boolean", "bool" })
+            typedefs.insert(make_pair(name, SpecialTypedefKind::Bool));
+        typedefs.insert(make_pair("unichar", SpecialTypedefKind::Unichar));
+        typedefs.insert(make_pair("__builtin_va_list", SpecialTypedefKind::VaList));
+#define CF_TYPE(NAME) typedefs.insert(make_pair(#NAME, SpecialTypedefKind::KnownBridged));
 #define NON_CF_TYPE(NAME)
 #include "CFDatabase.def"
 #undef CF_TYPE
 #undef NON_CF_TYPE
-};
+        return typedefs;
+    }();
+    return specialTypedefs;
+}
+
+// Walks the typedef chain once and returns the kind of the special typedef with the highest precedence in it
+static SpecialTypedefKind getSpecialTypedefKind(const clang::TypedefType* type)
+{
+    const llvm::StringMap<SpecialTypedefKind>& specialTypedefs = getSpecialTypedefs();
+    SpecialTypedefKind kind = SpecialTypedefKind::None;
+    const clang::TypedefNameDecl* decl = type->getDecl();
+    while (decl) {
+        if (const clang::IdentifierInfo* identifier = decl->getIdentifier()) {
+            llvm::StringMap<SpecialTypedefKind>::const_iterator it = specialTypedefs.find(identifier->getName());
+            if (it != specialTypedefs.end() && it->second < kind) {
+                kind = it->second;
+                if (kind == SpecialTypedefKind::Bool) {
+                    break;
+                }
+            }
+        }
+
+        const clang::Type* innerType = decl->getUnderlyingType().getTypePtr();
+        if (const clang::TypedefType* innerTypedef = clang::dyn_cast<clang::TypedefType>(innerType)) {
+            decl = innerTypedef->getDecl();
+        }
+        else {
+            decl = nullptr;
+        }
+    }
+    return kind;
+}
 
 shared_ptr<Type> TypeFactory::getVoid()
 {
@@ -135,122 +184,141 @@ shared_ptr<Type> TypeFactory::getProtocolType()
     return type;
 }
 
-shared_ptr<Type> TypeFactory::create(const clang::Type* type)
+CreationResult<shared_ptr<Type>> TypeFactory::create(const clang::Type* type)
 {
     const clang::Type& typeRef = *type;
-    shared_ptr<Type> resultType(nullptr);
-
-    try {
-        // check for cached Type
-        Cache::const_iterator cachedTypeIt = _cache.find(type);
-        if (cachedTypeIt != _cache.end()) {
-            shared_ptr<Type> resultType = cachedTypeIt->second.first;
-            if (auto creationException = cachedTypeIt->second.second.get()) {
-                POLYMORPHIC_THROW(creationException);
-            }
-
-            // revalidate in case the Type's metadata creation has failed after it was returned
-            // (e.g. from a forward declaration)
-            this->_metaFactory->validate(resultType.get());
+    // Validation results can't be reused if an incomplete meta has been involved
+    unsigned pendingDependencyCount = this->_metaFactory->getPendingDependencyCount();
+
+    // check for cached Type
+    Cache::iterator cachedTypeIt = _cache.find(type);
+    if (cachedTypeIt != _cache.end()) {
+        CacheEntry& entry = cachedTypeIt->second;
+        if (entry.exception) {
+            return entry.exception;
+        }
 
-            return resultType;
+        // revalidate in case the Type's metadata creation has failed after it was returned
+        // (e.g. from a forward declaration). Validation results stay correct as long as no meta
+        // has failed since the last successful validation, so skip the walk in that case.
+        if (entry.validatedGeneration != this->_metaFactory->getValidationGeneration()) {
+            if (shared_ptr<CreationException> exception = this->_metaFactory->validate(entry.type.get())) {
+                entry.exception = make_shared<TypeCreationException>(type, "Can't create meta dependency.", exception->isError(), exception);
+                return entry.exception;
+            }
+            entry.validatedGeneration = this->getValidatedGeneration(pendingDependencyCount);
         }
 
-        if (const clang::BuiltinType* concreteType = clang::dyn_cast<clang::BuiltinType>(type))
-            resultType = createFromBuiltinType(concreteType);
-        else if (const clang::TypedefType* concreteType = clang::dyn_cast<clang::TypedefType>(type))
-            resultType = createFromTypedefType(concreteType);
-        else if (const clang::ObjCObjectPointerType* concreteType = clang::dyn_cast<clang::ObjCObjectPointerType>(type))
-            resultType = createFromObjCObjectPointerType(concreteType);
-        else if (const clang::EnumType* concreteType = clang::dyn_cast<clang::EnumType>(type))
-            resultType = createFromEnumType(concreteType);
-        else if (const clang::PointerType* concreteType = clang::dyn_cast<clang::PointerType>(type))
-            resultType = createFromPointerType(concreteType);
-        else if (const clang::BlockPointerType* concreteType = clang::dyn_cast<clang::BlockPointerType>(type))
-            resultType = createFromBlockPointerType(concreteType);
-        else if (const clang::RecordType* concreteType = clang::dyn_cast<clang::RecordType>(type))
-            resultType = createFromRecordType(concreteType);
-        else if (const clang::ExtVectorType* concreteType = clang::dyn_cast<clang::ExtVectorType>(type))
-            resultType = createFromExtVectorType(concreteType);
-        else if (const clang::VectorType* concreteType = clang::dyn_cast<clang::VectorType>(type))
-            resultType = createFromVectorType(concreteType);
-        else if (const clang::ConstantArrayType* concreteType = clang::dyn_cast<clang::ConstantArrayType>(type))
-            resultType = createFromConstantArrayType(concreteType);
-        else if (const clang::IncompleteArrayType* concreteType = clang::dyn_cast<clang::IncompleteArrayType>(type))
-            resultType = createFromIncompleteArrayType(concreteType);
-        else if (const clang::ElaboratedType* concreteType = clang::dyn_cast<clang::ElaboratedType>(type))
-            resultType = createFromElaboratedType(concreteType);
-        else if (const clang::AdjustedType* concreteType = clang::dyn_cast<clang::AdjustedType>(type))
-            resultType = createFromAdjustedType(concreteType);
-        else if (const clang::FunctionProtoType* concreteType = clang::dyn_cast<clang::FunctionProtoType>(type))
-            resultType = createFromFunctionProtoType(concreteType);
-        else if (const clang::FunctionNoProtoType* concreteType = clang::dyn_cast<clang::FunctionNoProtoType>(type))
-            resultType = createFromFunctionNoProtoType(concreteType);
-        else if (const clang::ParenType* concreteType = clang::dyn_cast<clang::ParenType>(type))
-            resultType = createFromParenType(concreteType);
-        else if (const clang::AttributedType* concreteType = clang::dyn_cast<clang::AttributedType>(type))
-            resultType = createFromAttributedType(concreteType);
-        else if (const clang::ObjCTypeParamType* concreteType = clang::dyn_cast<clang::ObjCTypeParamType>(type))
-            resultType = createFromObjCTypeParamType(concreteType);
-        else
-            throw TypeCreationException(type, "Unable to create encoding for this type.", true);
-    }
-    catch (TypeCreationException& e) {
-        if (e.getType() == type) {
-            _cache.insert(make_pair(&typeRef, make_pair(nullptr, llvm::make_unique<TypeCreationException>(e))));
-            throw;
-        };
-        pair<Cache::iterator, bool> insertionResult = _cache.insert(make_pair(&typeRef, make_pair(nullptr, nullptr)));
-        string message = CreationException::constructMessage("Can't create type dependency.", e.getDetailedMessage());
-        insertionResult.first->second.second = llvm::make_unique<TypeCreationException>(type, message, e.isError());
-        POLYMORPHIC_THROW(insertionResult.first->second.second);
+        return entry.type;
     }
-    catch (MetaCreationException& e) {
-        pair<Cache::iterator, bool> insertionResult = _cache.insert(make_pair(&typeRef, make_pair(nullptr, nullptr)));
-        string message = CreationException::constructMessage("Can't create meta dependency.", e.getDetailedMessage());
-        insertionResult.first->second.second = llvm::make_unique<TypeCreationException>(type, message, e.isError());
-        POLYMORPHIC_THROW(insertionResult.first->second.second);
+
+    CreationResult<shared_ptr<Type>> result = this->createFromClangType(type);
+    if (!result) {
+        const shared_ptr<CreationException>& exception = result.getException();
+        const TypeCreationException* typeException = llvm::dyn_cast<TypeCreationException>(exception.get());
+        if (typeException != nullptr && typeException->getType() == type) {
+            CacheEntry failedEntry;
+            failedEntry.exception = exception;
+            _cache.insert(make_pair(&typeRef, std::move(failedEntry)));
+            return exception;
+        }
+        CacheEntry& entry = _cache[&typeRef];
+        const char* message = (typeException != nullptr) ? "Can't create type dependency." : "Can't create meta dependency.";
+        entry.exception = make_shared<TypeCreationException>(type, message, exception->isError(), exception);
+        return entry.exception;
     }
 
+    shared_ptr<Type>& resultType = result.getValue();
     assert(resultType != nullptr);
-    pair<Cache::iterator, bool> insertionResult = _cache.insert(make_pair(&typeRef, make_pair(nullptr, nullptr)));
+    pair<Cache::iterator, bool> insertionResult = _cache.insert(make_pair(&typeRef, CacheEntry()));
+    CacheEntry& entry = insertionResult.first->second;
     if (insertionResult.second) {
-        assert(insertionResult.first->second.first.get() == nullptr);
-        insertionResult.first->second.first = resultType;
+        assert(entry.type.get() == nullptr);
+        entry.type = resultType;
+        // All metas the type refers to have just been created successfully
+        entry.validatedGeneration = this->getValidatedGeneration(pendingDependencyCount);
         return resultType;
     }
     else {
-        return insertionResult.first->second.first;
+        return entry.type;
     }
 }
 
-shared_ptr<Type> TypeFactory::create(const clang::QualType& type)
+CreationResult<shared_ptr<Type>> TypeFactory::create(const clang::QualType& type)
 {
     const clang::Type* typePtr = type.getTypePtrOrNull();
     if (typePtr)
         return this->create(typePtr);
-    throw TypeCreationException(nullptr, "Unable to get the inner type of qualified type.", true);
-}
-
-shared_ptr<ConstantArrayType> TypeFactory::createFromConstantArrayType(const clang::ConstantArrayType* type)
-{
-    return make_shared<ConstantArrayType>(this->create(type->getElementType()).get(), (int)type->getSize().roundToDouble());
-}
-
-shared_ptr<IncompleteArrayType> TypeFactory::createFromIncompleteArrayType(const clang::IncompleteArrayType* type)
-{
-    return make_shared<IncompleteArrayType>(this->create(type->getElementType()).get());
-}
-
-shared_ptr<BlockType> TypeFactory::createFromBlockPointerType(const clang::BlockPointerType* type)
+    return make_shared<TypeCreationException>(nullptr, "Unable to get the inner type of qualified type.", true);
+}
+
+CreationResult<shared_ptr<Type>> TypeFactory::createFromClangType(const clang::Type* type)
+{
+    if (const clang::BuiltinType* concreteType = clang::dyn_cast<clang::BuiltinType>(type))
+        return createFromBuiltinType(concreteType);
+    else if (const clang::TypedefType* concreteType = clang::dyn_cast<clang::TypedefType>(type))
+        return createFromTypedefType(concreteType);
+    else if (const clang::ObjCObjectPointerType* concreteType = clang::dyn_cast<clang::ObjCObjectPointerType>(type))
+        return createFromObjCObjectPointerType(concreteType);
+    else if (const clang::EnumType* concreteType = clang::dyn_cast<clang::EnumType>(type))
+        return createFromEnumType(concreteType);
+    else if (const clang::PointerType* concreteType = clang::dyn_cast<clang::PointerType>(type))
+        return createFromPointerType(concreteType);
+    else if (const clang::BlockPointerType* concreteType = clang::dyn_cast<clang::BlockPointerType>(type))
+        return createFromBlockPointerType(concreteType);
+    else if (const clang::RecordType* concreteType = clang::dyn_cast<clang::RecordType>(type))
+        return createFromRecordType(concreteType);
+    else if (const clang::ExtVectorType* concreteType = clang::dyn_cast<clang::ExtVectorType>(type))
+        return createFromExtVectorType(concreteType);
+    else if (const clang::VectorType* concreteType = clang::dyn_cast<clang::VectorType>(type))
+        return createFromVectorType(concreteType);
+    else if (const clang::ConstantArrayType* concreteType = clang::dyn_cast<clang::ConstantArrayType>(type))
+        return createFromConstantArrayType(concreteType);
+    else if (const clang::IncompleteArrayType* concreteType = clang::dyn_cast<clang::IncompleteArrayType>(type))
+        return createFromIncompleteArrayType(concreteType);
+    else if (const clang::ElaboratedType* concreteType = clang::dyn_cast<clang::ElaboratedType>(type))
+        return createFromElaboratedType(concreteType);
+    else if (const clang::AdjustedType* concreteType = clang::dyn_cast<clang::AdjustedType>(type))
+        return createFromAdjustedType(concreteType);
+    else if (const clang::FunctionProtoType* concreteType = clang::dyn_cast<clang::FunctionProtoType>(type))
+        return createFromFunctionProtoType(concreteType);
+    else if (const clang::FunctionNoProtoType* concreteType = clang::dyn_cast<clang::FunctionNoProtoType>(type))
+        return createFromFunctionNoProtoType(concreteType);
+    else if (const clang::ParenType* concreteType = clang::dyn_cast<clang::ParenType>(type))
+        return createFromParenType(concreteType);
+    else if (const clang::AttributedType* concreteType = clang::dyn_cast<clang::AttributedType>(type))
+        return createFromAttributedType(concreteType);
+    else if (const clang::ObjCTypeParamType* concreteType = clang::dyn_cast<clang::ObjCTypeParamType>(type))
+        return createFromObjCTypeParamType(concreteType);
+    else
+        return make_shared<TypeCreationException>(type, "Unable to create encoding for this type.", true);
+}
+
+CreationResult<shared_ptr<Type>> TypeFactory::createFromConstantArrayType(const clang::ConstantArrayType* type)
+{
+    CreationResult<shared_ptr<Type>> elementType = this->create(type->getElementType());
+    RETURN_IF_FAILED(elementType);
+    return make_shared<ConstantArrayType>(elementType.getValue().get(), (int)type->getSize().roundToDouble());
+}
+
+CreationResult<shared_ptr<Type>> TypeFactory::createFromIncompleteArrayType(const clang::IncompleteArrayType* type)
+{
+    CreationResult<shared_ptr<Type>> elementType = this->create(type->getElementType());
+    RETURN_IF_FAILED(elementType);
+    return make_shared<IncompleteArrayType>(elementType.getValue().get());
+}
+
+CreationResult<shared_ptr<Type>> TypeFactory::createFromBlockPointerType(const clang::BlockPointerType* type)
 {
     const clang::Type* pointee = type->getPointeeType().getTypePtr();
-    Type* pointeeType = this->create(pointee).get();
+    CreationResult<shared_ptr<Type>> pointeeResult = this->create(pointee);
+    RETURN_IF_FAILED(pointeeResult);
+    Type* pointeeType = pointeeResult.getValue().get();
     assert(pointeeType->is(TypeType::TypeFunctionPointer));
     return make_shared<BlockType>(pointeeType->as<FunctionPointerType>().signature);
 }
 
-shared_ptr<Type> TypeFactory::createFromBuiltinType(const clang::BuiltinType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromBuiltinType(const clang::BuiltinType* type)
 {
     switch (type->getKind()) {
     case clang::BuiltinType::Kind::Void:
@@ -293,11 +361,12 @@ shared_ptr<Type> TypeFactory::createFromBuiltinType(const clang::BuiltinType* ty
     // This is also valid for ObjCClass type.
 
     default:
-        throw TypeCreationException(type, string("Not supported builtin type(") + type->getTypeClassName() + ").", true);
+        // BuiltinType::getTypeClassName() is always "Builtin"
+        return make_shared<TypeCreationException>(type, "Not supported builtin type(Builtin).", true);
     }
 }
 
-shared_ptr<Type> TypeFactory::createFromObjCObjectPointerType(const clang::ObjCObjectPointerType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromObjCObjectPointerType(const clang::ObjCObjectPointerType* type)
 {
     vector<ProtocolMeta*> protocols;
     for (clang::ObjCProtocolDecl* qual : type->quals()) {
@@ -322,17 +391,20 @@ shared_ptr<Type> TypeFactory::createFromObjCObjectPointerType(const clang::ObjCO
         else if (clang::ObjCInterfaceDecl* interfaceDef = interface->getDefinition()) {
             vector<Type*> typeArguments;
             for (const clang::QualType& typeArg : type->getTypeArgsAsWritten()) {
-
-                typeArguments.push_back(this->create(typeArg).get());
+                CreationResult<shared_ptr<Type>> typeArgument = this->create(typeArg);
+                RETURN_IF_FAILED(typeArgument);
+                typeArguments.push_back(typeArgument.getValue().get());
             }
-            return make_shared<InterfaceType>(&_metaFactory->create(*interfaceDef)->as<InterfaceMeta>(), protocols, typeArguments);
+            CreationResult<Meta*> interfaceMeta = _metaFactory->create(*interfaceDef);
+            RETURN_IF_FAILED(interfaceMeta);
+            return make_shared<InterfaceType>(&interfaceMeta.getValue()->as<InterfaceMeta>(), protocols, typeArguments);
         }
     }
 
-    throw TypeCreationException(type, "Invalid interface pointer type.", true);
+    return make_shared<TypeCreationException>(type, "Invalid interface pointer type.", true);
 }
 
-shared_ptr<Type> TypeFactory::createFromPointerType(const clang::PointerType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromPointerType(const clang::PointerType* type)
 {
     clang::QualType qualPointee = type->getPointeeType();
     const clang::Type* pointee = qualPointee.getTypePtr();
@@ -350,18 +422,22 @@ shared_ptr<Type> TypeFactory::createFromPointerType(const clang::PointerType* ty
         return this->create(qualPointee);
     }
 
-    return make_shared<PointerType>(this->create(qualPointee).get());
+    CreationResult<shared_ptr<Type>> pointeeType = this->create(qualPointee);
+    RETURN_IF_FAILED(pointeeType);
+    return make_shared<PointerType>(pointeeType.getValue().get());
 }
 
-shared_ptr<Type> TypeFactory::createFromEnumType(const clang::EnumType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromEnumType(const clang::EnumType* type)
 {
-    Type* innerType = this->create(type->getDecl()->getIntegerType()).get();
+    CreationResult<shared_ptr<Type>> innerType = this->create(type->getDecl()->getIntegerType());
+    RETURN_IF_FAILED(innerType);
     auto& enumDecl = type->getDecl()->getDefinition() ? *type->getDecl()->getDefinition() : *type->getDecl();
-    EnumMeta* enumMeta = &this->_metaFactory->create(enumDecl)->as<EnumMeta>();
-    return make_shared<EnumType>(innerType, enumMeta);
+    CreationResult<Meta*> enumMeta = this->_metaFactory->create(enumDecl);
+    RETURN_IF_FAILED(enumMeta);
+    return make_shared<EnumType>(innerType.getValue().get(), &enumMeta.getValue()->as<EnumMeta>());
 }
 
-shared_ptr<Type> TypeFactory::createFromRecordType(const clang::RecordType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromRecordType(const clang::RecordType* type)
 {
 
     clang::RecordDecl* recordDef = type->getDecl()->getDefinition();
@@ -369,21 +445,25 @@ shared_ptr<Type> TypeFactory::createFromRecordType(const clang::RecordType* type
         return TypeFactory::getVoid();
     }
     if (recordDef->isUnion())
-        throw TypeCreationException(type, "The record is an union.", true);
+        return make_shared<TypeCreationException>(type, "The record is an union.", true);
     if (!recordDef->isStruct())
-        throw TypeCreationException(type, "The record is not a struct.", true);
+        return make_shared<TypeCreationException>(type, "The record is not a struct.", true);
     const clang::TagDecl* tagDecl = clang::dyn_cast<clang::TagDecl>(type->getDecl());
     if (MetaFactory::getTypedefOrOwnName(tagDecl) == "") {
         // The record is anonymous
         vector<RecordField> fields;
         for (clang::FieldDecl* field : recordDef->fields()) {
-            RecordField fieldMeta(field->getNameAsString(), this->create(field->getType()).get());
+            CreationResult<shared_ptr<Type>> fieldType = this->create(field->getType());
+            RETURN_IF_FAILED(fieldType);
+            RecordField fieldMeta(field->getNameAsString(), fieldType.getValue().get());
             fields.push_back(fieldMeta);
         }
         return make_shared<AnonymousStructType>(fields);
     }
 
-    return make_shared<StructType>(&_metaFactory->create(*recordDef)->as<StructMeta>());
+    CreationResult<Meta*> structMeta = _metaFactory->create(*recordDef);
+    RETURN_IF_FAILED(structMeta);
+    return make_shared<StructType>(&structMeta.getValue()->as<StructMeta>());
 }
 
 static shared_ptr<Type> tryCreateFromBridgedType(const clang::Type* type)
@@ -412,71 +492,80 @@ static shared_ptr<Type> tryCreateFromBridgedType(const clang::Type* type)
     return nullptr;
 }
 
-shared_ptr<Type> TypeFactory::createFromTypedefType(const clang::TypedefType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromTypedefType(const clang::TypedefType* type)
 {
-    vector<string> boolTypedefs{ "BOOL", "Boolean", "bool"};
-    if (isSpecificTypedefType(type, boolTypedefs))
+    SpecialTypedefKind specialKind = getSpecialTypedefKind(type);
+    if (specialKind == SpecialTypedefKind::Bool)
         return TypeFactory::getBool();
-    if (isSpecificTypedefType(type, "unichar"))
+    if (specialKind == SpecialTypedefKind::Unichar)
         return TypeFactory::getUnichar();
-    if (isSpecificTypedefType(type, "__builtin_va_list"))
-        throw TypeCreationException(type, "VaList type is not supported.", true);
+    if (specialKind == SpecialTypedefKind::VaList)
+        return make_shared<TypeCreationException>(type, "VaList type is not supported.", true);
     if (auto bridgedInterfaceType = tryCreateFromBridgedType(type->getDecl()->getUnderlyingType().getTypePtrOrNull())) {
         return bridgedInterfaceType;
     }
-    if (isSpecificTypedefType(type, KNOWN_BRIDGED_TYPES)) {
+    if (specialKind == SpecialTypedefKind::KnownBridged) {
         return make_shared<BridgedInterfaceType>("id", nullptr);
     }
     return this->create(type->getDecl()->getUnderlyingType());
 }
 
-shared_ptr<Type> TypeFactory::createFromExtVectorType(const clang::ExtVectorType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromExtVectorType(const clang::ExtVectorType* type)
 {
-    return make_shared<ExtVectorType>(this->create(type->getElementType()).get(), type->getNumElements());
+    CreationResult<shared_ptr<Type>> elementType = this->create(type->getElementType());
+    RETURN_IF_FAILED(elementType);
+    return make_shared<ExtVectorType>(elementType.getValue().get(), type->getNumElements());
 }
 
-shared_ptr<Type> TypeFactory::createFromVectorType(const clang::VectorType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromVectorType(const clang::VectorType* type)
 {
-    throw TypeCreationException(type, "Vector type is not supported.", true);
+    return make_shared<TypeCreationException>(type, "Vector type is not supported.", true);
 }
 
-shared_ptr<Type> TypeFactory::createFromElaboratedType(const clang::ElaboratedType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromElaboratedType(const clang::ElaboratedType* type)
 {
     return this->create(type->getNamedType());
 }
 
-shared_ptr<Type> TypeFactory::createFromAdjustedType(const clang::AdjustedType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromAdjustedType(const clang::AdjustedType* type)
 {
     return this->create(type->getOriginalType());
 }
 
-shared_ptr<Type> TypeFactory::createFromFunctionProtoType(const clang::FunctionProtoType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromFunctionProtoType(const clang::FunctionProtoType* type)
 {
     vector<Type*> signature;
-    signature.push_back(this->create(type->getReturnType()).get());
-    for (const clang::QualType& parm : type->param_types())
-        signature.push_back(this->create(parm).get());
+    CreationResult<shared_ptr<Type>> returnType = this->create(type->getReturnType());
+    RETURN_IF_FAILED(returnType);
+    signature.push_back(returnType.getValue().get());
+    for (const clang::QualType& parm : type->param_types()) {
+        CreationResult<shared_ptr<Type>> parmType = this->create(parm);
+        RETURN_IF_FAILED(parmType);
+        signature.push_back(parmType.getValue().get());
+    }
     return make_shared<FunctionPointerType>(signature);
 }
 
-shared_ptr<Type> TypeFactory::createFromFunctionNoProtoType(const clang::FunctionNoProtoType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromFunctionNoProtoType(const clang::FunctionNoProtoType* type)
 {
     vector<Type*> signature;
-    signature.push_back(this->create(type->getReturnType()).get());
+    CreationResult<shared_ptr<Type>> returnType = this->create(type->getReturnType());
+    RETURN_IF_FAILED(returnType);
+    signature.push_back(returnType.getValue().get());
     return make_shared<FunctionPointerType>(signature);
 }
 
-shared_ptr<Type> TypeFactory::createFromParenType(const clang::ParenType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromParenType(const clang::ParenType* type)
 {
     return this->create(type->desugar().getTypePtr());
 }
 
-shared_ptr<Type> TypeFactory::createFromAttributedType(const clang::AttributedType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromAttributedType(const clang::AttributedType* type)
 {
     return this->create(type->getModifiedType());
 }
 
-shared_ptr<Type> TypeFactory::createFromObjCTypeParamType(const clang::ObjCTypeParamType* type)
+CreationResult<shared_ptr<Type>> TypeFactory::createFromObjCTypeParamType(const clang::ObjCTypeParamType* type)
 {
     clang::ObjCTypeParamDecl* typeParamDecl = type->getDecl();
 
@@ -490,40 +579,26 @@ shared_ptr<Type> TypeFactory::createFromObjCTypeParamType(const clang::ObjCTypeP
         }
     }
 
-    return make_shared<TypeArgumentType>(this->create(typeParamDecl->getUnderlyingType()).get(), typeParamDecl->getNameAsString(), protocols);
+    CreationResult<shared_ptr<Type>> underlyingType = this->create(typeParamDecl->getUnderlyingType());
+    RETURN_IF_FAILED(underlyingType);
+    return make_shared<TypeArgumentType>(underlyingType.getValue().get(), typeParamDecl->getNameAsString(), protocols);
 }
 
-bool TypeFactory::isSpecificTypedefType(const clang::TypedefType* type, const string& typedefName)
+unsigned TypeFactory::getValidatedGeneration(unsigned pendingDependencyCount)
 {
-    const vector<string> typedefNames{ typedefName };
-    return this->isSpecificTypedefType(type, typedefNames);
-}
-
-bool TypeFactory::isSpecificTypedefType(const clang::TypedefType* type, const vector<string>& typedefNames)
-{
-    clang::TypedefNameDecl* decl = type->getDecl();
-    while (decl) {
-        if (find(typedefNames.begin(), typedefNames.end(), decl->getNameAsString()) != typedefNames.end()) {
-            return true;
-        }
-
-        clang::Type const* innerType = decl->getUnderlyingType().getTypePtr();
-        if (const clang::TypedefType* innerTypedef = clang::dyn_cast<clang::TypedefType>(innerType)) {
-            decl = innerTypedef->getDecl();
-        }
-        else {
-            return false;
-        }
+    if (this->_metaFactory->getPendingDependencyCount() != pendingDependencyCount) {
+        // Some of the metas are still being created and may fail later
+        return 0;
     }
-    return false;
+    return this->_metaFactory->getValidationGeneration();
 }
 
 void TypeFactory::resolveCachedBridgedInterfaceTypes(unordered_map<string, InterfaceMeta*>& interfaceMap)
 {
     unordered_map<string, InterfaceMeta*>::const_iterator nsObjectIt = interfaceMap.find("NSObject");
     for (Cache::value_type& typeEntry : _cache) {
-        if (typeEntry.second.second.get() == nullptr) {
-            Type* type = typeEntry.second.first.get();
+        if (typeEntry.second.exception.get() == nullptr) {
+            Type* type = typeEntry.second.type.get();
             if (type->is(TypeType::TypeBridgedInterface)) {
                 BridgedInterfaceType* bridgedType = &type->as<BridgedInterfaceType>();
                 if (!bridgedType->isId()) {
@@ -57,56 +57,64 @@ public:
 
     static std::shared_ptr<Type> getProtocolType();
 
-    std::shared_ptr<Type> create(const clang::Type* type);
+    CreationResult<std::shared_ptr<Type>> create(const clang::Type* type);
 
-    std::shared_ptr<Type> create(const clang::QualType& type);
+    CreationResult<std::shared_ptr<Type>> create(const clang::QualType& type);
 
     void resolveCachedBridgedInterfaceTypes(std::unordered_map<std::string, InterfaceMeta*>& interfaceMap);
 
 private:
-    std::shared_ptr<ConstantArrayType> createFromConstantArrayType(const clang::ConstantArrayType* type);
+    CreationResult<std::shared_ptr<Type>> createFromClangType(const clang::Type* type);
 
-    std::shared_ptr<IncompleteArrayType> createFromIncompleteArrayType(const clang::IncompleteArrayType* type);
+    CreationResult<std::shared_ptr<Type>> createFromConstantArrayType(const clang::ConstantArrayType* type);
 
-    std::shared_ptr<BlockType> createFromBlockPointerType(const clang::BlockPointerType* type);
+    CreationResult<std::shared_ptr<Type>> createFromIncompleteArrayType(const clang::IncompleteArrayType* type);
 
-    std::shared_ptr<Type> createFromBuiltinType(const clang::BuiltinType* type);
+    CreationResult<std::shared_ptr<Type>> createFromBlockPointerType(const clang::BlockPointerType* type);
 
-    std::shared_ptr<Type> createFromObjCObjectPointerType(const clang::ObjCObjectPointerType* type);
+    CreationResult<std::shared_ptr<Type>> createFromBuiltinType(const clang::BuiltinType* type);
 
-    std::shared_ptr<Type> createFromPointerType(const clang::PointerType* type);
+    CreationResult<std::shared_ptr<Type>> createFromObjCObjectPointerType(const clang::ObjCObjectPointerType* type);
 
-    std::shared_ptr<Type> createFromEnumType(const clang::EnumType* type);
+    CreationResult<std::shared_ptr<Type>> createFromPointerType(const clang::PointerType* type);
 
-    std::shared_ptr<Type> createFromRecordType(const clang::RecordType* type);
+    CreationResult<std::shared_ptr<Type>> createFromEnumType(const clang::EnumType* type);
 
-    std::shared_ptr<Type> createFromTypedefType(const clang::TypedefType* type);
+    CreationResult<std::shared_ptr<Type>> createFromRecordType(const clang::RecordType* type);
+
+    CreationResult<std::shared_ptr<Type>> createFromTypedefType(const clang::TypedefType* type);
     
-    std::shared_ptr<Type> createFromExtVectorType(const clang::ExtVectorType* type);
+    CreationResult<std::shared_ptr<Type>> createFromExtVectorType(const clang::ExtVectorType* type);
 
-    std::shared_ptr<Type> createFromVectorType(const clang::VectorType* type);
+    CreationResult<std::shared_ptr<Type>> createFromVectorType(const clang::VectorType* type);
 
-    std::shared_ptr<Type> createFromElaboratedType(const clang::ElaboratedType* type);
+    CreationResult<std::shared_ptr<Type>> createFromElaboratedType(const clang::ElaboratedType* type);
 
-    std::shared_ptr<Type> createFromAdjustedType(const clang::AdjustedType* type);
+    CreationResult<std::shared_ptr<Type>> createFromAdjustedType(const clang::AdjustedType* type);
 
-    std::shared_ptr<Type> createFromFunctionProtoType(const clang::FunctionProtoType* type);
+    CreationResult<std::shared_ptr<Type>> createFromFunctionProtoType(const clang::FunctionProtoType* type);
 
-    std::shared_ptr<Type> createFromFunctionNoProtoType(const clang::FunctionNoProtoType* type);
+    CreationResult<std::shared_ptr<Type>> createFromFunctionNoProtoType(const clang::FunctionNoProtoType* type);
 
-    std::shared_ptr<Type> createFromParenType(const clang::ParenType* type);
+    CreationResult<std::shared_ptr<Type>> createFromParenType(const clang::ParenType* type);
 
-    std::shared_ptr<Type> createFromAttributedType(const clang::AttributedType* type);
+    CreationResult<std::shared_ptr<Type>> createFromAttributedType(const clang::AttributedType* type);
 
-    std::shared_ptr<Type> createFromObjCTypeParamType(const clang::ObjCTypeParamType* type);
+    CreationResult<std::shared_ptr<Type>> createFromObjCTypeParamType(const clang::ObjCTypeParamType* type);
 
     // helpers
-    bool isSpecificTypedefType(const clang::TypedefType* type, const std::string& typedefName);
+    unsigned getValidatedGeneration(unsigned pendingDependencyCount);
 
-    bool isSpecificTypedefType(const clang::TypedefType* type, const std::vector<std::string>& typedefNames);
+    struct CacheEntry {
+        std::shared_ptr<Type> type;
+        std::shared_ptr<CreationException> exception;
+        // The MetaFactory validation generation at which the type was last known to be valid.
+        // Zero means that the type has never been validated.
+        unsigned validatedGeneration = 0;
+    };
 
     MetaFactory* _metaFactory;
-    typedef std::unordered_map<const clang::Type*, std::pair<std::shared_ptr<Type>, std::unique_ptr<CreationException> > > Cache;
+    typedef std::unordered_map<const clang::Type*, CacheEntry> Cache;
     Cache _cache;
 };
 }
@@ -7,6 +7,10 @@
 
 #include "ValidateMetaTypeVisitor.h"
 
+bool ValidateMetaTypeVisitor::validate(Meta* meta) {
+    this->_exception = this->_metaFactory.validate(meta);
+    return this->_exception == nullptr;
+}
 
 bool ValidateMetaTypeVisitor::visitVoid() {
     return true;
@@ -86,7 +90,9 @@ bool ValidateMetaTypeVisitor::visitInstancetype() {
 
 bool ValidateMetaTypeVisitor::visitClass(const ClassType& typeDetails) {
     for (auto& p : typeDetails.protocols) {
-        this->_metaFactory.validate(p);
+        if (!this->validate(p)) {
+            return false;
+        }
     }
 
     return true;
@@ -113,15 +119,20 @@ bool ValidateMetaTypeVisitor::visitIncompleteArray(const IncompleteArrayType& ty
 }
 
 bool ValidateMetaTypeVisitor::visitInterface(const InterfaceType& typeDetails) {
-    
-    this->_metaFactory.validate(typeDetails.interface);
+    if (!this->validate(typeDetails.interface)) {
+        return false;
+    }
 
     for (auto& p : typeDetails.protocols) {
-        this->_metaFactory.validate(p);
+        if (!this->validate(p)) {
+            return false;
+        }
     }
     
     for (auto typeArg : typeDetails.typeArguments) {
-        typeArg->visit(*this);
+        if (!typeArg->visit(*this)) {
+            return false;
+        }
     }
     
     return true;
@@ -129,21 +140,21 @@ bool ValidateMetaTypeVisitor::visitInterface(const InterfaceType& typeDetails) {
 
 bool ValidateMetaTypeVisitor::visitBridgedInterface(const BridgedInterfaceType& typeDetails) {
     if (typeDetails.bridgedInterface) {
-        this->_metaFactory.validate(typeDetails.bridgedInterface);
+        return this->validate(typeDetails.bridgedInterface);
     }
     
     return true;
 }
 
 bool ValidateMetaTypeVisitor::visitPointer(const PointerType& typeDetails) {
-    typeDetails.innerType->visit(*this);
-    
-    return true;
+    return typeDetails.innerType->visit(*this);
 }
 
 bool ValidateMetaTypeVisitor::visitBlock(const BlockType& typeDetails) {
     for (auto type : typeDetails.signature) {
-        type->visit(*this);
+        if (!type->visit(*this)) {
+            return false;
+        }
     }
     
     return true;
@@ -151,27 +162,27 @@ bool ValidateMetaTypeVisitor::visitBlock(const BlockType& typeDetails) {
 
 bool ValidateMetaTypeVisitor::visitFunctionPointer(const FunctionPointerType& typeDetails) {
     for (auto type : typeDetails.signature) {
-        type->visit(*this);
+        if (!type->visit(*this)) {
+            return false;
+        }
     }
     
     return true;
 }
 
 bool ValidateMetaTypeVisitor::visitStruct(const StructType& typeDetails) {
-    this->_metaFactory.validate(typeDetails.structMeta);
-
-    return true;
+    return this->validate(typeDetails.structMeta);
 }
 
 bool ValidateMetaTypeVisitor::visitUnion(const UnionType& typeDetails) {
-    this->_metaFactory.validate(typeDetails.unionMeta);
-
-    return true;
+    return this->validate(typeDetails.unionMeta);
 }
 
 bool ValidateMetaTypeVisitor::visitAnonymousStruct(const AnonymousStructType& typeDetails) {
     for (auto field : typeDetails.fields) {
-        field.encoding->visit(*this);
+        if (!field.encoding->visit(*this)) {
+            return false;
+        }
     }
 
     return true;
@@ -179,25 +190,25 @@ bool ValidateMetaTypeVisitor::visitAnonymousStruct(const AnonymousStructType& ty
 
 bool ValidateMetaTypeVisitor::visitAnonymousUnion(const AnonymousUnionType& typeDetails) {
     for (auto field : typeDetails.fields) {
-        field.encoding->visit(*this);
+        if (!field.encoding->visit(*this)) {
+            return false;
+        }
     }
     
     return true;
 }
 
 bool ValidateMetaTypeVisitor::visitEnum(const EnumType& typeDetails) {
-    this->_metaFactory.validate(typeDetails.enumMeta);
-
-    return true;
+    return this->validate(typeDetails.enumMeta);
 }
 
 bool ValidateMetaTypeVisitor::visitTypeArgument(const TypeArgumentType& typeDetails) {
     for (auto& p : typeDetails.protocols) {
-        this->_metaFactory.validate(p);
+        if (!this->validate(p)) {
+            return false;
+        }
     }
     
-    typeDetails.underlyingType->visit(*this);
-
-    return true;
+    return typeDetails.underlyingType->visit(*this);
 }
 
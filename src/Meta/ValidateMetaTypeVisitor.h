@@ -91,9 +91,17 @@ public:
     
     virtual bool visitTypeArgument(const ::Meta::TypeArgumentType& type);
 
+    // The reason the last visited type is invalid, nullptr if it is valid
+    const std::shared_ptr<CreationException>& getException() const
+    {
+        return _exception;
+    }
     
 private:
+    bool validate(Meta* meta);
+
     MetaFactory& _metaFactory;
+    std::shared_ptr<CreationException> _exception;
 };
 
 #endif /* ValidateMetaTypeVisitor_h */
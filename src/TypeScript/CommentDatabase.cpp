@@ -0,0 +1,210 @@
+#include "CommentDatabase.h"
+#include "Utils/OutputFile.h"
+#include <cstring>
+
+namespace TypeScript {
+// File layout: magic, docset version, entries count and the entries. Each entry is a key followed by the size of
+// the serialized comment and the comment itself. Numbers are stored in the byte order of the machine.
+static const char databaseMagic[8] = { 'T', 'S', 'C', 'O', 'M', 'M', 'D', 'B' };
+
+class DatabaseReader {
+public:
+    explicit DatabaseReader(llvm::StringRef data)
+        : _data(data)
+    {
+    }
+
+    template <class T>
+    bool readNumber(T& value)
+    {
+        if (_data.size() < sizeof(T)) {
+            return false;
+        }
+        memcpy(&value, _data.data(), sizeof(T));
+        _data = _data.drop_front(sizeof(T));
+        return true;
+    }
+
+    bool readBytes(size_t size, llvm::StringRef& bytes)
+    {
+        if (_data.size() < size) {
+            return false;
+        }
+        bytes = _data.substr(0, size);
+        _data = _data.drop_front(size);
+        return true;
+    }
+
+    bool readString(llvm::StringRef& string)
+    {
+        uint32_t size;
+        return readNumber(size) && readBytes(size, string);
+    }
+
+    // Reads the count of the items which follow. A count that doesn't fit in the remaining data is rejected
+    // before anything is allocated for the items, so that a damaged file can't cause huge allocations.
+    bool readCount(uint32_t& count, size_t minimumItemSize)
+    {
+        return readNumber(count) && count <= _data.size() / minimumItemSize;
+    }
+
+    bool readComment(TSComment& comment)
+    {
+        llvm::StringRef description;
+        uint32_t paramsCount;
+        if (!readString(description) || !readCount(paramsCount, minimumParamSize)) {
+            return false;
+        }
+        comment.description = description.str();
+        for (uint32_t i = 0; i < paramsCount; i++) {
+            llvm::StringRef name, paramDescription;
+            if (!readString(name) || !readString(paramDescription)) {
+                return false;
+            }
+            comment.params.push_back(std::make_pair(name.str(), paramDescription.str()));
+        }
+
+        uint32_t fieldsCount;
+        if (!readCount(fieldsCount, minimumCommentSize)) {
+            return false;
+        }
+        comment.fields.resize(fieldsCount);
+        for (TSComment& field : comment.fields) {
+            if (!readComment(field)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The sizes of an entry, a parameter and a comment with empty strings and no items
+    static const size_t minimumEntrySize = 2 * sizeof(uint32_t);
+    static const size_t minimumParamSize = 2 * sizeof(uint32_t);
+    static const size_t minimumCommentSize = 3 * sizeof(uint32_t);
+
+private:
+    llvm::StringRef _data;
+};
+
+template <class T>
+static void writeNumber(std::string& output, T value)
+{
+    output.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void writeString(std::string& output, llvm::StringRef string)
+{
+    writeNumber(output, static_cast<uint32_t>(string.size()));
+    output.append(string.data(), string.size());
+}
+
+static void writeComment(std::string& output, const TSComment& comment)
+{
+    writeString(output, comment.description);
+    writeNumber(output, static_cast<uint32_t>(comment.params.size()));
+    for (const std::pair<std::string, std::string>& param : comment.params) {
+        writeString(output, param.first);
+        writeString(output, param.second);
+    }
+    writeNumber(output, static_cast<uint32_t>(comment.fields.size()));
+    for (const TSComment& field : comment.fields) {
+        writeComment(output, field);
+    }
+}
+
+static void writeEntry(std::string& output, llvm::StringRef key, llvm::StringRef serializedComment)
+{
+    writeString(output, key);
+    writeString(output, serializedComment);
+}
+
+CommentDatabase::CommentDatabase(std::string filePath, uint64_t docSetVersion)
+    : _filePath(std::move(filePath))
+    , _docSetVersion(docSetVersion)
+{
+    this->load();
+}
+
+void CommentDatabase::load()
+{
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer> > buffer = llvm::MemoryBuffer::getFile(_filePath);
+    if (!buffer) {
+        return;
+    }
+
+    DatabaseReader reader((*buffer)->getBuffer());
+    llvm::StringRef magic;
+    uint64_t version;
+    uint32_t count;
+    if (!reader.readBytes(sizeof(databaseMagic), magic) || magic != llvm::StringRef(databaseMagic, sizeof(databaseMagic))
+        || !reader.readNumber(version) || version != _docSetVersion || !reader.readCount(count, DatabaseReader::minimumEntrySize)) {
+        return;
+    }
+
+    llvm::DenseMap<llvm::StringRef, llvm::StringRef> comments;
+    comments.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        llvm::StringRef key, serializedComment;
+        if (!reader.readString(key) || !reader.readString(serializedComment)) {
+            // A truncated file is ignored as a whole
+            return;
+        }
+        comments[key] = serializedComment;
+    }
+
+    _buffer = std::move(*buffer);
+    _comments = std::move(comments);
+}
+
+bool CommentDatabase::find(const std::string& key, TSComment& comment) const
+{
+    llvm::DenseMap<llvm::StringRef, llvm::StringRef>::const_iterator it = _comments.find(key);
+    if (it != _comments.end()) {
+        TSComment loadedComment;
+        if (DatabaseReader(it->second).readComment(loadedComment)) {
+            comment = std::move(loadedComment);
+            return true;
+        }
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::unordered_map<std::string, TSComment>::const_iterator addedIt = _addedComments.find(key);
+    if (addedIt != _addedComments.end()) {
+        comment = addedIt->second;
+        return true;
+    }
+    return false;
+}
+
+void CommentDatabase::add(const std::string& key, const TSComment& comment)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _addedComments.emplace(key, comment);
+}
+
+bool CommentDatabase::save()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_addedComments.empty()) {
+        return true;
+    }
+
+    std::string output;
+    output.append(databaseMagic, sizeof(databaseMagic));
+    writeNumber(output, _docSetVersion);
+    writeNumber(output, static_cast<uint32_t>(_comments.size() + _addedComments.size()));
+    for (const auto& entry : _comments) {
+        writeEntry(output, entry.first, entry.second);
+    }
+    std::string serializedComment;
+    for (const std::pair<const std::string, TSComment>& entry : _addedComments) {
+        serializedComment.clear();
+        writeComment(serializedComment, entry.second);
+        writeEntry(output, entry.first, serializedComment);
+    }
+
+    // The file is written to a temporary one first, so the mapped file stays intact until it's replaced
+    return !utils::OutputFile::write(_filePath, output);
+}
+}
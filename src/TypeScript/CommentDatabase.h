@@ -0,0 +1,46 @@
+#pragma once
+
+#include "DocSetManager.h"
+#include <cstdint>
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace TypeScript {
+/*
+ * \class CommentDatabase
+ * \brief A file which holds the TypeScript comments extracted from a docset, so that later runs don't have to parse its XML files.
+ *
+ * The file is mapped in memory and the comments are decoded on lookup. It is only used if it has been created from
+ * the same docset version. Comments which are not found in it are added by the managers and the file is rewritten
+ * by \c save. The database can be used from multiple threads.
+ */
+class CommentDatabase {
+public:
+    CommentDatabase(std::string filePath, uint64_t docSetVersion);
+
+    bool find(const std::string& key, TSComment& comment) const;
+
+    void add(const std::string& key, const TSComment& comment);
+
+    // Writes the database to its file if comments have been added to it. Returns false on error.
+    bool save();
+
+private:
+    void load();
+
+    std::string _filePath;
+    uint64_t _docSetVersion;
+
+    // The loaded file and the serialized comments in it by key
+    std::unique_ptr<llvm::MemoryBuffer> _buffer;
+    llvm::DenseMap<llvm::StringRef, llvm::StringRef> _comments;
+
+    mutable std::mutex _mutex;
+    std::unordered_map<std::string, TSComment> _addedComments;
+};
+}
@@ -3,6 +3,7 @@
 #include "Meta/NameRetrieverVisitor.h"
 #include "Utils/StringUtils.h"
 #include <algorithm>
+#include <cassert>
 #include <clang/AST/DeclObjC.h>
 #include <iterator>
 
@@ -59,14 +60,29 @@ static std::vector<std::string> getTypeParameterNames(const clang::ObjCInterface
     return params;
 }
     
-std::string DefinitionWriter::getTypeArgumentsStringOrEmpty(const clang::ObjCObjectType* objectType)
+DefinitionWriter::BaseTypeArguments DefinitionWriter::getBaseTypeArguments(const std::vector<std::pair<clang::Module*, std::vector< ::Meta::Meta*> >*>& modules, TypeFactory& typeFactory)
+{
+    BaseTypeArguments baseTypeArguments;
+    for (const std::pair<clang::Module*, std::vector< ::Meta::Meta*> >* module : modules) {
+        for (::Meta::Meta* meta : module->second) {
+            if (meta->is(MetaType::Interface) && meta->as<InterfaceMeta>().base != nullptr) {
+                const clang::ObjCInterfaceDecl* interfaceDecl = clang::cast<clang::ObjCInterfaceDecl>(meta->declaration);
+                baseTypeArguments[&meta->as<InterfaceMeta>()] = getTypeArgumentsStringOrEmpty(interfaceDecl->getSuperClassType(), typeFactory);
+            }
+        }
+    }
+    return baseTypeArguments;
+}
+
+std::string DefinitionWriter::getTypeArgumentsStringOrEmpty(const clang::ObjCObjectType* objectType, TypeFactory& typeFactory)
 {
     std::ostringstream output;
     llvm::ArrayRef<clang::QualType> typeArgs = objectType->getTypeArgsAsWritten();
     if (!typeArgs.empty()) {
         output << "<";
         for (unsigned i = 0; i < typeArgs.size(); i++) {
-            output << tsifyType(*_typeFactory.create(typeArgs[i]));
+            CreationResult<std::shared_ptr<Type>> typeArg = typeFactory.create(typeArgs[i]);
+            output << (typeArg ? tsifyType(*typeArg.getValue()) : "any");
             if (i < typeArgs.size() - 1) {
                 output << ", ";
             }
@@ -125,9 +141,7 @@ void DefinitionWriter::visit(InterfaceMeta* meta)
 
     std::unordered_set<ProtocolMeta*> inheritedProtocols;
 
-    CompoundMemberMap<MethodMeta> inheritedStaticMethods;
-    getInheritedMembersRecursive(meta, &inheritedStaticMethods, nullptr, nullptr, nullptr);
-    for (auto& methodPair : inheritedStaticMethods) {
+    for (const auto& methodPair : _inheritedMembers.getStaticMethods(meta)) {
         MethodMeta* method = methodPair.second.second;
         if (!method->signature[0]->is(TypeInstancetype)) {
             continue;
@@ -151,26 +165,28 @@ void DefinitionWriter::visit(InterfaceMeta* meta)
         }
     }
     
-    _buffer << std::endl
+    *_output << '\n'
             << _docSet.getCommentFor(meta).toString("") << "declare class " << metaJsName << parametersString;
     if (meta->base != nullptr) {
-        _buffer << " extends " << localizeReference(*meta->base) << getTypeArgumentsStringOrEmpty(clang::cast<clang::ObjCInterfaceDecl>(meta->declaration)->getSuperClassType());
+        BaseTypeArguments::const_iterator typeArgumentsIt = _baseTypeArguments.find(meta);
+        assert(typeArgumentsIt != _baseTypeArguments.end());
+        *_output << " extends " << localizeReference(*meta->base) << typeArgumentsIt->second;
     }
 
     CompoundMemberMap<PropertyMeta> protocolInheritedStaticProperties;
     CompoundMemberMap<PropertyMeta> protocolInheritedInstanceProperties;
     std::unordered_set<ProtocolMeta*> protocols;
     if (meta->protocols.size()) {
-        _buffer << " implements ";
+        *_output << " implements ";
         for (size_t i = 0; i < meta->protocols.size(); i++) {
             getProtocolMembersRecursive(meta->protocols[i], &compoundStaticMethods, &compoundInstanceMethods, &protocolInheritedStaticProperties, &protocolInheritedInstanceProperties, protocols);
-            _buffer << localizeReference(*meta->protocols[i]);
+            *_output << localizeReference(*meta->protocols[i]);
             if (i < meta->protocols.size() - 1) {
-                _buffer << ", ";
+                *_output << ", ";
             }
         }
     }
-    _buffer << " {" << std::endl;
+    *_output << " {" << '\n';
 
     std::unordered_set<ProtocolMeta*> immediateProtocols;
     for (auto protocol : protocols) {
@@ -188,9 +204,9 @@ void DefinitionWriter::visit(InterfaceMeta* meta)
         if (output.size()) {
             MethodMeta* method = methodPair.second.second;
             BaseClassMeta* owner = methodPair.second.first;
-            _buffer << std::endl
+            *_output << '\n'
                     << _docSet.getCommentFor(method, owner).toString("\t");
-            _buffer << "\tstatic " << output << std::endl;
+            *_output << "\tstatic " << output << '\n';
         }
     }
 
@@ -232,18 +248,18 @@ void DefinitionWriter::visit(InterfaceMeta* meta)
     if (objectAtIndexedSubscript != compoundInstanceMethods.end()) {
         const Type* retType = objectAtIndexedSubscript->second.second->signature[0];
         std::string indexerReturnType = computeMethodReturnType(retType, meta, true);
-        _buffer << "\t[index: number]: " << indexerReturnType << ";" << std::endl;
+        *_output << "\t[index: number]: " << indexerReturnType << ";" << '\n';
     }
 
     if (compoundInstanceMethods.find("countByEnumeratingWithStateObjectsCount") != compoundInstanceMethods.end()) {
-        _buffer << "\t[Symbol.iterator](): Iterator<any>;" << std::endl;
+        *_output << "\t[Symbol.iterator](): Iterator<any>;" << '\n';
     }
 
     for (auto& methodPair : compoundInstanceMethods) {
         if (methodPair.second.second->getFlags(MethodIsInitializer)) {
-            _buffer << std::endl
+            *_output << '\n'
                     << _docSet.getCommentFor(methodPair.second.second, methodPair.second.first).toString("\t");
-            _buffer << "\t" << writeConstructor(methodPair, meta) << std::endl;
+            *_output << "\t" << writeConstructor(methodPair, meta) << '\n';
         }
     }
 
@@ -258,27 +274,27 @@ void DefinitionWriter::visit(InterfaceMeta* meta)
 
         std::string output = writeMethod(methodPair, meta, immediateProtocols, true);
         if (output.size()) {
-            _buffer << std::endl
+            *_output << '\n'
                     << _docSet.getCommentFor(methodPair.second.second, methodPair.second.first).toString("\t");
-            _buffer << "\t" << output << std::endl;
+            *_output << "\t" << output << '\n';
         }
     }
 
-    _buffer << "}" << std::endl;
+    *_output << "}" << '\n';
 }
 
-void DefinitionWriter::writeProperty(PropertyMeta* propertyMeta, BaseClassMeta* owner, InterfaceMeta* target, CompoundMemberMap<PropertyMeta> baseClassProperties)
+void DefinitionWriter::writeProperty(PropertyMeta* propertyMeta, BaseClassMeta* owner, InterfaceMeta* target, const CompoundMemberMap<PropertyMeta>& baseClassProperties)
 {
-    _buffer << std::endl
+    *_output << '\n'
             << _docSet.getCommentFor(propertyMeta, owner).toString("\t");
-    _buffer << "\t";
+    *_output << "\t";
 
     if (clang::cast<clang::ObjCPropertyDecl>(propertyMeta->declaration)->isClassProperty()) {
-        _buffer << "static ";
+        *_output << "static ";
     }
 
     if (!propertyMeta->setter) {
-        _buffer << "readonly ";
+        *_output << "readonly ";
     }
 
     bool optOutTypeChecking = false;
@@ -286,65 +302,13 @@ void DefinitionWriter::writeProperty(PropertyMeta* propertyMeta, BaseClassMeta*
     if (result != baseClassProperties.end()) {
         optOutTypeChecking = result->second.second->getter->signature[0] != propertyMeta->getter->signature[0];
     }
-    _buffer << writeProperty(propertyMeta, target, optOutTypeChecking);
+    *_output << writeProperty(propertyMeta, target, optOutTypeChecking);
 
     if (owner != target) {
-        _buffer << " // inherited from " << localizeReference(*owner);
-    }
-
-    _buffer << std::endl;
-}
-
-void DefinitionWriter::getInheritedMembersRecursive(InterfaceMeta* interface,
-    CompoundMemberMap<MethodMeta>* staticMethods,
-    CompoundMemberMap<MethodMeta>* instanceMethods,
-    CompoundMemberMap<PropertyMeta>* staticProperties,
-    CompoundMemberMap<PropertyMeta>* instanceProperties)
-{
-    auto base = interface->base;
-    if (!base) {
-        return;
-    }
-
-    if (staticMethods) {
-        for (MethodMeta* method : base->staticMethods) {
-            if (staticMethods->find(method->jsName) == staticMethods->end()) {
-                staticMethods->emplace(method->jsName, std::make_pair(base, method));
-            }
-        }
-    }
-
-    if (instanceMethods) {
-        for (MethodMeta* method : base->instanceMethods) {
-            if (instanceMethods->find(method->jsName) == instanceMethods->end()) {
-                instanceMethods->emplace(method->jsName, std::make_pair(base, method));
-            }
-        }
-    }
-
-    if (staticProperties) {
-        for (PropertyMeta* property : base->staticProperties) {
-            if (staticProperties->find(property->jsName) == staticProperties->end()) {
-                staticProperties->emplace(property->jsName, std::make_pair(base, property));
-            }
-        }
-    }
-
-    if (instanceProperties) {
-        for (PropertyMeta* property : base->instanceProperties) {
-            if (instanceProperties->find(property->jsName) == instanceProperties->end()) {
-                instanceProperties->emplace(property->jsName, std::make_pair(base, property));
-            }
-        }
-    }
-
-    // accumulate...
-    std::unordered_set<ProtocolMeta*> protocols;
-    for (auto protocol : base->protocols) {
-        getProtocolMembersRecursive(protocol, staticMethods, instanceMethods, staticProperties, instanceProperties, protocols);
+        *_output << " // inherited from " << localizeReference(*owner);
     }
 
-    getInheritedMembersRecursive(base, staticMethods, instanceMethods, staticProperties, instanceProperties);
+    *_output << '\n';
 }
 
 void DefinitionWriter::getProtocolMembersRecursive(ProtocolMeta* protocolMeta,
@@ -395,7 +359,7 @@ void DefinitionWriter::getProtocolMembersRecursive(ProtocolMeta* protocolMeta,
 
 void DefinitionWriter::visit(ProtocolMeta* meta)
 {
-    _buffer << std::endl
+    *_output << '\n'
             << _docSet.getCommentFor(meta).toString("");
     
     std::string metaName = meta->jsName;
@@ -407,42 +371,42 @@ void DefinitionWriter::visit(ProtocolMeta* meta)
         }
     }
 
-    _buffer << "interface " << metaName;
+    *_output << "interface " << metaName;
     std::map<std::string, PropertyMeta*> conformedProtocolsProperties;
     if (meta->protocols.size()) {
-        _buffer << " extends ";
+        *_output << " extends ";
         for (size_t i = 0; i < meta->protocols.size(); i++) {
             std::transform(meta->protocols[i]->instanceProperties.begin(), meta->protocols[i]->instanceProperties.end(), std::inserter(conformedProtocolsProperties, conformedProtocolsProperties.end()), [](PropertyMeta* propertyMeta) {
                 return std::make_pair(propertyMeta->jsName, propertyMeta);
             });
 
-            _buffer << localizeReference(*meta->protocols[i]);
+            *_output << localizeReference(*meta->protocols[i]);
             if (i < meta->protocols.size() - 1) {
-                _buffer << ", ";
+                *_output << ", ";
             }
         }
     }
-    _buffer << " {" << std::endl;
+    *_output << " {" << '\n';
 
     for (PropertyMeta* property : meta->instanceProperties) {
         bool optOutTypeChecking = conformedProtocolsProperties.find(property->jsName) != conformedProtocolsProperties.end();
-        _buffer << std::endl
-                << _docSet.getCommentFor(property, meta).toString("\t") << "\t" << writeProperty(property, meta, optOutTypeChecking) << std::endl;
+        *_output << '\n'
+                << _docSet.getCommentFor(property, meta).toString("\t") << "\t" << writeProperty(property, meta, optOutTypeChecking) << '\n';
     }
 
     for (MethodMeta* method : meta->instanceMethods) {
         if (hiddenMethods.find(method->jsName) == hiddenMethods.end()) {
-            _buffer << std::endl
-                    << _docSet.getCommentFor(method, meta).toString("\t") << "\t" << writeMethod(method, meta) << std::endl;
+            *_output << '\n'
+                    << _docSet.getCommentFor(method, meta).toString("\t") << "\t" << writeMethod(method, meta) << '\n';
         }
     }
 
-    _buffer << "}" << std::endl;
+    *_output << "}" << '\n';
 
-    _buffer << "declare var " << metaName << ": {" << std::endl;
+    *_output << "declare var " << metaName << ": {" << '\n';
 
-    _buffer << std::endl
-            << "\tprototype: " << metaName << ";" << std::endl;
+    *_output << '\n'
+            << "\tprototype: " << metaName << ";" << '\n';
 
     CompoundMemberMap<MethodMeta> compoundStaticMethods;
     for (MethodMeta* method : meta->staticMethods) {
@@ -459,13 +423,13 @@ void DefinitionWriter::visit(ProtocolMeta* meta)
         if (output.size()) {
             MethodMeta* method = methodPair.second.second;
             BaseClassMeta* owner = methodPair.second.first;
-            _buffer << std::endl
+            *_output << '\n'
                     << _docSet.getCommentFor(method, owner).toString("\t");
-            _buffer << "\t" << output << std::endl;
+            *_output << "\t" << output << '\n';
         }
     }
 
-    _buffer << "};" << std::endl;
+    *_output << "};" << '\n';
 }
 
 std::string DefinitionWriter::writeConstructor(const CompoundMemberMap<MethodMeta>::value_type& initializer,
@@ -474,28 +438,32 @@ std::string DefinitionWriter::writeConstructor(const CompoundMemberMap<MethodMet
     MethodMeta* method = initializer.second.second;
     assert(method->getFlags(MethodIsInitializer));
 
-    std::ostringstream output;
+    std::string output;
+    output.reserve(64);
 
     if (method->constructorTokens == "") {
-        output << "constructor();";
+        output += "constructor();";
     }
     else {
         std::vector<std::string> ctorTokens;
         StringUtils::split(method->constructorTokens, ':', std::back_inserter(ctorTokens));
-        output << "constructor(o: { ";
+        output += "constructor(o: { ";
         for (size_t i = 0; i < ctorTokens.size(); i++) {
-            output << ctorTokens[i] << ": ";
-            output << (i + 1 < method->signature.size() ? tsifyType(*method->signature[i + 1], true) : "void") << "; ";
+            output += ctorTokens[i];
+            output += ": ";
+            output += (i + 1 < method->signature.size() ? tsifyType(*method->signature[i + 1], true) : "void");
+            output += "; ";
         }
-        output << "});";
+        output += "});";
     }
 
     BaseClassMeta* initializerOwner = initializer.second.first;
     if (initializerOwner != owner) {
-        output << " // inherited from " << initializerOwner->jsName;
+        output += " // inherited from ";
+        output += initializerOwner->jsName;
     }
 
-    return output.str();
+    return output;
 }
     
 void getClosedGenericsIfAny(Type& type, std::vector<Type*>& params)
@@ -551,9 +519,10 @@ std::string DefinitionWriter::writeMethod(MethodMeta* meta, BaseClassMeta* owner
         }
     }
 
-    std::ostringstream output;
+    std::string output;
+    output.reserve(128);
 
-    output << meta->jsName;
+    output += meta->jsName;
     bool skipGenerics = false;
 
     if (DefinitionWriter::applyManualChanges) {
@@ -568,26 +537,26 @@ std::string DefinitionWriter::writeMethod(MethodMeta* meta, BaseClassMeta* owner
     
     if (!methodDecl.isInstanceMethod() && owner->is(MetaType::Interface)) {
         if ((retType->is(TypeInstancetype) || DefinitionWriter::hasClosedGenerics(*retType)) && !skipGenerics) {
-            output << getTypeParametersStringOrEmpty(
+            output += getTypeParametersStringOrEmpty(
                 clang::cast<clang::ObjCInterfaceDecl>(static_cast<const InterfaceMeta*>(owner)->declaration));
         } else if (!paramsGenerics.empty()) {
-            output << "<";
+            output += "<";
             for (size_t i = 0; i < paramsGenerics.size(); i++) {
                 auto name = paramsGenerics[i]->visit(NameRetrieverVisitor::instanceTs);
-                output << name;
+                output += name;
                 if (i < paramsGenerics.size() - 1) {
-                    output << ", ";
+                    output += ", ";
                 }
             }
-            output << ">";
+            output += ">";
         }
     }
 
     if ((owner->type == MetaType::Protocol && methodDecl.getImplementationControl() == clang::ObjCMethodDecl::ImplementationControl::Optional) || (owner->is(MetaType::Protocol) && meta->getFlags(MethodIsInitializer))) {
-        output << "?";
+        output += "?";
     }
 
-    output << "(";
+    output += "(";
 
     size_t lastParamIndex = meta->getFlags(::Meta::MetaFlags::MethodHasErrorOutParameter) ? (meta->signature.size() - 1) : meta->signature.size();
     
@@ -603,27 +572,31 @@ std::string DefinitionWriter::writeMethod(MethodMeta* meta, BaseClassMeta* owner
     
     for (size_t i = 1; i < lastParamIndex; i++) {
         
-        output << sanitizeParameterName(parameterNames[i - 1]) << ": " << tsifyType(*meta->signature[i], true);
+        output += sanitizeParameterName(parameterNames[i - 1]);
+        output += ": ";
+        output += tsifyType(*meta->signature[i], true);
 
         if (i < lastParamIndex - 1) {
-            output << ", ";
+            output += ", ";
         }
         
     }
     
-    output << "): ";
+    output += "): ";
     if (skipGenerics) {
-        output << "any;";
+        output += "any;";
     } else {
-        output << computeMethodReturnType(retType, owner, canUseThisType) << ";";
+        output += computeMethodReturnType(retType, owner, canUseThisType);
+        output += ";";
     }
     
-    return output.str();
+    return output;
 }
 
 std::string DefinitionWriter::writeMethod(CompoundMemberMap<MethodMeta>::value_type& methodPair, BaseClassMeta* owner, const std::unordered_set<ProtocolMeta*>& protocols, bool canUseThisType)
 {
-    std::ostringstream output;
+    std::string output;
+    output.reserve(128);
 
     BaseClassMeta* memberOwner = methodPair.second.first;
     MethodMeta* method = methodPair.second.second;
@@ -637,37 +610,43 @@ std::string DefinitionWriter::writeMethod(CompoundMemberMap<MethodMeta>::value_t
     bool returnsInstanceType = method->signature[0]->is(TypeInstancetype);
 
     if (isOwnMethod || implementsProtocol || returnsInstanceType) {
-        output << writeMethod(method, owner, canUseThisType);
+        output += writeMethod(method, owner, canUseThisType);
         if (!isOwnMethod && !implementsProtocol) {
-            output << " // inherited from " << localizeReference(memberOwner->jsName, memberOwner->module->getFullModuleName());
+            output += " // inherited from ";
+            output += localizeReference(memberOwner->jsName, memberOwner->module->getFullModuleName());
         }
     }
 
-    return output.str();
+    return output;
 }
 
 std::string DefinitionWriter::writeProperty(PropertyMeta* meta, BaseClassMeta* owner, bool optOutTypeChecking)
 {
-    std::ostringstream output;
+    std::string output;
+    output.reserve(64);
 
     if (hiddenMethods.find(meta->jsName) != hiddenMethods.end()) {
         return std::string();
     }
 
-    output << meta->jsName;
+    output += meta->jsName;
     if (owner->is(MetaType::Protocol) && clang::dyn_cast<clang::ObjCPropertyDecl>(meta->declaration)->getPropertyImplementation() == clang::ObjCPropertyDecl::PropertyControl::Optional) {
-        output << "?";
+        output += "?";
     }
 
     std::string returnType = tsifyType(*meta->getter->signature[0]);
     if (optOutTypeChecking) {
-        output << ": any; /*" << returnType << " */";
+        output += ": any; /*";
+        output += returnType;
+        output += " */";
     }
     else {
-        output << ": " << returnType << ";";
+        output += ": ";
+        output += returnType;
+        output += ";";
     }
 
-    return output.str();
+    return output;
 }
 
 void DefinitionWriter::visit(CategoryMeta* meta)
@@ -687,9 +666,9 @@ void DefinitionWriter::visit(FunctionMeta* meta)
         }
     }
 
-    _buffer << std::endl
+    *_output << '\n'
             << _docSet.getCommentFor(meta).toString("");
-    _buffer << "declare function " << meta->jsName
+    *_output << "declare function " << meta->jsName
             << "(" << params.str() << "): ";
 
     std::string returnName;
@@ -703,9 +682,9 @@ void DefinitionWriter::visit(FunctionMeta* meta)
         }
     }
 
-    _buffer << returnName << ";";
+    *_output << returnName << ";";
 
-    _buffer << std::endl;
+    *_output << '\n';
 }
 
 void DefinitionWriter::visit(StructMeta* meta)
@@ -720,84 +699,89 @@ void DefinitionWriter::visit(StructMeta* meta)
     }
     
     TSComment comment = _docSet.getCommentFor(meta);
-    _buffer << std::endl
+    *_output << '\n'
             << comment.toString("");
 
-    _buffer << "interface " << metaName << " {" << std::endl;
+    *_output << "interface " << metaName << " {" << '\n';
     writeMembers(meta->fields, comment.fields);
-    _buffer << "}" << std::endl;
+    *_output << "}" << '\n';
 
-    _buffer << "declare var " << metaName << ": interop.StructType<" << metaName << ">;";
+    *_output << "declare var " << metaName << ": interop.StructType<" << metaName << ">;";
 
-    _buffer << std::endl;
+    *_output << '\n';
 }
 
 void DefinitionWriter::visit(UnionMeta* meta)
 {
     TSComment comment = _docSet.getCommentFor(meta);
-    _buffer << std::endl
+    *_output << '\n'
             << comment.toString("");
 
-    _buffer << "interface " << meta->jsName << " {" << std::endl;
+    *_output << "interface " << meta->jsName << " {" << '\n';
     writeMembers(meta->fields, comment.fields);
-    _buffer << "}" << std::endl;
+    *_output << "}" << '\n';
 
-    _buffer << std::endl;
+    *_output << '\n';
 }
 
 void DefinitionWriter::writeMembers(const std::vector<RecordField>& fields, std::vector<TSComment> fieldsComments)
 {
     for (size_t i = 0; i < fields.size(); i++) {
         if (i < fieldsComments.size()) {
-            _buffer << fieldsComments[i].toString("\t");
+            *_output << fieldsComments[i].toString("\t");
         }
-        _buffer << "\t" << fields[i].name << ": " << tsifyType(*fields[i].encoding) << ";" << std::endl;
+        *_output << "\t" << fields[i].name << ": " << tsifyType(*fields[i].encoding) << ";" << '\n';
     }
 }
 
 void DefinitionWriter::visit(EnumMeta* meta)
 {
-    _buffer << std::endl
+    *_output << '\n'
             << _docSet.getCommentFor(meta).toString("");
-    _buffer << "declare const enum " << meta->jsName << " {" << std::endl;
+    *_output << "declare const enum " << meta->jsName << " {" << '\n';
 
     std::vector<EnumField>& fields = meta->swiftNameFields.size() != 0 ? meta->swiftNameFields : meta->fullNameFields;
 
     for (size_t i = 0; i < fields.size(); i++) {
-        _buffer << std::endl
+        *_output << '\n'
                 << _docSet.getCommentFor(meta->fullNameFields[i].name, MetaType::EnumConstant).toString("\t");
-        _buffer << "\t" << fields[i].name << " = " << fields[i].value;
+        *_output << "\t" << fields[i].name << " = " << fields[i].value;
         if (i < fields.size() - 1) {
-            _buffer << ",";
+            *_output << ",";
         }
-        _buffer << std::endl;
+        *_output << '\n';
     }
 
-    _buffer << "}";
-    _buffer << std::endl;
+    *_output << "}";
+    *_output << '\n';
 }
 
 void DefinitionWriter::visit(VarMeta* meta)
 {
-    _buffer << std::endl
+    *_output << '\n'
             << _docSet.getCommentFor(meta).toString("");
-    _buffer << "declare var " << meta->jsName << ": " << tsifyType(*meta->signature) << ";" << std::endl;
+    *_output << "declare var " << meta->jsName << ": " << tsifyType(*meta->signature) << ";" << '\n';
 }
 
 std::string DefinitionWriter::writeFunctionProto(const std::vector<Type*>& signature)
 {
-    std::ostringstream output;
-    output << "(";
+    std::string output;
+    output.reserve(64);
+    output += "(";
 
     for (size_t i = 1; i < signature.size(); i++) {
-        output << "p" << i << ": " << tsifyType(*signature[i]);
+        output += "p";
+        output += std::to_string(i);
+        output += ": ";
+        output += tsifyType(*signature[i]);
         if (i < signature.size() - 1) {
-            output << ", ";
+            output += ", ";
         }
     }
 
-    output << ") => " << tsifyType(*signature[0]);
-    return output.str();
+    output += ") => ";
+    output += tsifyType(*signature[0]);
+    return output;
 }
 
 void DefinitionWriter::visit(MethodMeta* meta)
@@ -815,9 +799,9 @@ void DefinitionWriter::visit(EnumConstantMeta* meta)
         return;
     }
 
-    _buffer << std::endl;
-    _buffer << "declare const " << meta->jsName << ": number;";
-    _buffer << std::endl;
+    *_output << '\n';
+    *_output << "declare const " << meta->jsName << ": number;";
+    *_output << '\n';
 }
 
 std::string DefinitionWriter::localizeReference(const std::string& jsName, std::string moduleName)
@@ -848,6 +832,23 @@ bool DefinitionWriter::hasClosedGenerics(const Type& type)
 }
 
 std::string DefinitionWriter::tsifyType(const Type& type, const bool isFuncParam)
+{
+    // The types are owned by the type factory until the end of the run, so their addresses identify them.
+    // Each of the threads writing the modules has its own cache.
+    thread_local std::unordered_map<const Type*, std::string> cache[2];
+
+    std::unordered_map<const Type*, std::string>& typeNames = cache[isFuncParam ? 1 : 0];
+    std::unordered_map<const Type*, std::string>::const_iterator it = typeNames.find(&type);
+    if (it != typeNames.end()) {
+        return it->second;
+    }
+
+    std::string typeName = tsifyTypeUncached(type, isFuncParam);
+    typeNames.emplace(&type, typeName);
+    return typeName;
+}
+
+std::string DefinitionWriter::tsifyTypeUncached(const Type& type, const bool isFuncParam)
 {
     switch (type.getType()) {
     case TypeVoid:
@@ -874,7 +875,7 @@ std::string DefinitionWriter::tsifyType(const Type& type, const bool isFuncParam
         std::string res = "string";
         if (isFuncParam) {
             Type typeVoid(TypeVoid);
-            res += " | " + tsifyType(::Meta::PointerType(&typeVoid), isFuncParam);
+            res += " | " + tsifyTypeUncached(::Meta::PointerType(&typeVoid), isFuncParam);
         }
         return res;
     }
@@ -910,7 +911,7 @@ std::string DefinitionWriter::tsifyType(const Type& type, const bool isFuncParam
     case TypeInterface:
     case TypeBridgedInterface: {
         if (type.is(TypeType::TypeBridgedInterface) && type.as<BridgedInterfaceType>().isId()) {
-            return tsifyType(IdType());
+            return tsifyTypeUncached(IdType());
         }
 
         const InterfaceMeta& interface = type.is(TypeType::TypeInterface) ? *type.as<InterfaceType>().interface : *type.as<BridgedInterfaceType>().bridgedInterface;
@@ -930,50 +931,53 @@ std::string DefinitionWriter::tsifyType(const Type& type, const bool isFuncParam
             }
     }
 
-        std::ostringstream output;
-        output << localizeReference(interface);
+        std::string output;
+        output.reserve(64);
+        output += localizeReference(interface);
 
         bool hasClosedGenerics = DefinitionWriter::hasClosedGenerics(type);
         std::string firstElementType;
         if (hasClosedGenerics) {
             const InterfaceType& interfaceType = type.as<InterfaceType>();
-            output << "<";
+            output += "<";
             for (size_t i = 0; i < interfaceType.typeArguments.size(); i++) {
                 std::string argType = tsifyType(*interfaceType.typeArguments[i]);
-                output << argType;
+                output += argType;
                 if (i == 0) {
                     firstElementType = argType;//we only need this for NSArray
                 }
                 if (i < interfaceType.typeArguments.size() - 1) {
-                    output << ", ";
+                    output += ", ";
                 }
             }
-            output << ">";
+            output += ">";
         }
         else {
             // This also translates CFArray to NSArray<any>
             if (auto typeParamList = clang::dyn_cast<clang::ObjCInterfaceDecl>(interface.declaration)->getTypeParamListAsWritten()) {
-                output << "<";
+                output += "<";
                 for (size_t i = 0; i < typeParamList->size(); i++) {
-                    output << "any";
+                    output += "any";
                     if (i < typeParamList->size() - 1) {
-                        output << ", ";
+                        output += ", ";
                     }
                 }
-                output << ">";
+                output += ">";
             }
         }
         
         if (interface.name == "NSArray" && isFuncParam) {
             if (hasClosedGenerics) {
                 std::string arrayType = firstElementType;
-                output << " | " << arrayType << "[]";
+                output += " | ";
+                output += arrayType;
+                output += "[]";
             } else {
-                output << " | any[]";
+                output += " | any[]";
             }
         }
 
-        return output.str();
+        return output;
     }
     case TypeStruct:
         return localizeReference(*type.as<StructType>().structMeta);
@@ -981,16 +985,20 @@ std::string DefinitionWriter::tsifyType(const Type& type, const bool isFuncParam
         return localizeReference(*type.as<UnionType>().unionMeta);
     case TypeAnonymousStruct:
     case TypeAnonymousUnion: {
-        std::ostringstream output;
-        output << "{ ";
+        std::string output;
+        output.reserve(64);
+        output += "{ ";
 
         const std::vector<RecordField>& fields = type.as<AnonymousStructType>().fields;
         for (auto& field : fields) {
-            output << field.name << ": " << tsifyType(*field.encoding) << "; ";
+            output += field.name;
+            output += ": ";
+            output += tsifyType(*field.encoding);
+            output += "; ";
         }
 
-        output << "}";
-        return output.str();
+        output += "}";
+        return output;
     }
     case TypeEnum:
         return localizeReference(*type.as<EnumType>().enumMeta);
@@ -1008,10 +1016,11 @@ std::string DefinitionWriter::tsifyType(const Type& type, const bool isFuncParam
 
 std::string DefinitionWriter::computeMethodReturnType(const Type* retType, const BaseClassMeta* owner, bool instanceMember)
 {
-    std::ostringstream output;
+    std::string output;
+    output.reserve(32);
     if (retType->is(TypeInstancetype)) {
         if (instanceMember) {
-            output << "this";
+            output += "this";
         }
         else {
             
@@ -1023,31 +1032,26 @@ std::string DefinitionWriter::computeMethodReturnType(const Type* retType, const
                 }
             }
             
-            output << ownerJsName;
+            output += ownerJsName;
             if (owner->is(MetaType::Interface)) {
-                output << getTypeParametersStringOrEmpty(clang::cast<clang::ObjCInterfaceDecl>(static_cast<const InterfaceMeta*>(owner)->declaration));
+                output += getTypeParametersStringOrEmpty(clang::cast<clang::ObjCInterfaceDecl>(static_cast<const InterfaceMeta*>(owner)->declaration));
             }
         }
     }
     else {
-        output << tsifyType(*retType);
+        output += tsifyType(*retType);
     }
 
-    return output.str();
+    return output;
 }
 
-std::string DefinitionWriter::write()
+void DefinitionWriter::write(llvm::raw_ostream& output)
 {
-    _buffer.clear();
+    _output = &output;
     _importedModules.clear();
     for (::Meta::Meta* meta : _module.second) {
         meta->visit(this);
     }
-
-    std::ostringstream output;
-
-    output << _buffer.str();
-
-    return output.str();
+    _output = nullptr;
 }
 }
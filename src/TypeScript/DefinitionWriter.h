@@ -1,23 +1,35 @@
 #pragma once
 
 #include "DocSetManager.h"
+#include "InheritedMembers.h"
 #include "Meta/MetaEntities.h"
 #include <Meta/TypeFactory.h>
+#include <llvm/Support/raw_ostream.h>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace TypeScript {
 class DefinitionWriter : Meta::MetaVisitor {
 public:
-    DefinitionWriter(std::pair<clang::Module*, std::vector<Meta::Meta*> >& module, Meta::TypeFactory& typeFactory, std::string docSetPath)
+    // The type arguments written after the base class of each interface (e.g. "<string>" in "extends NSArray<string>")
+    typedef std::unordered_map<const Meta::InterfaceMeta*, std::string> BaseTypeArguments;
+
+    DefinitionWriter(std::pair<clang::Module*, std::vector<Meta::Meta*> >& module, const BaseTypeArguments& baseTypeArguments, const InheritedMembers& inheritedMembers, std::string docSetPath, CommentDatabase* commentDatabase = nullptr)
         : _module(module)
-        , _typeFactory(typeFactory)
-        , _docSet(docSetPath)
+        , _baseTypeArguments(baseTypeArguments)
+        , _inheritedMembers(inheritedMembers)
+        , _docSet(docSetPath, commentDatabase)
     {
     }
 
-    std::string write();
+    // Spells the base type arguments of the interfaces in the given modules. It uses the type factory and the clang AST,
+    // neither of which can be used concurrently, so it has to be called before the writers of the modules start.
+    static BaseTypeArguments getBaseTypeArguments(const std::vector<std::pair<clang::Module*, std::vector<Meta::Meta*> >*>& modules, Meta::TypeFactory& typeFactory);
+
+    // Writes the definitions of the module's metas directly to the output stream
+    void write(llvm::raw_ostream& output);
     
     static bool applyManualChanges;
 
@@ -44,17 +56,8 @@ public:
     virtual void visit(Meta::EnumConstantMeta* meta) override;
 
 private:
-    template <class Member>
-    using CompoundMemberMap = std::map<std::string, std::pair<Meta::BaseClassMeta*, Member*> >;
-
     void writeMembers(const std::vector<Meta::RecordField>& fields, std::vector<TSComment> fieldsComments);
-    void writeProperty(Meta::PropertyMeta* meta, Meta::BaseClassMeta* owner, Meta::InterfaceMeta* target, CompoundMemberMap<Meta::PropertyMeta> compoundProperties);
-
-    static void getInheritedMembersRecursive(Meta::InterfaceMeta* interface,
-        CompoundMemberMap<Meta::MethodMeta>* staticMethods,
-        CompoundMemberMap<Meta::MethodMeta>* instanceMethods,
-        CompoundMemberMap<Meta::PropertyMeta>* staticProperties,
-        CompoundMemberMap<Meta::PropertyMeta>* instanceProperties);
+    void writeProperty(Meta::PropertyMeta* meta, Meta::BaseClassMeta* owner, Meta::InterfaceMeta* target, const CompoundMemberMap<Meta::PropertyMeta>& compoundProperties);
 
     static void getProtocolMembersRecursive(Meta::ProtocolMeta* protocol,
         CompoundMemberMap<Meta::MethodMeta>* staticMethods,
@@ -73,15 +76,18 @@ private:
     static std::string localizeReference(const std::string& jsName, std::string moduleName);
     static std::string localizeReference(const Meta::Meta& meta);
     static std::string tsifyType(const Meta::Type& type, const bool isParam = false);
+    // Temporary types must be passed to the uncached version, since their addresses are reused
+    static std::string tsifyTypeUncached(const Meta::Type& type, const bool isParam = false);
     static std::string computeMethodReturnType(const Meta::Type* retType, const Meta::BaseClassMeta* owner, bool canUseThisType = false);
-    std::string getTypeArgumentsStringOrEmpty(const clang::ObjCObjectType* objectType);
+    static std::string getTypeArgumentsStringOrEmpty(const clang::ObjCObjectType* objectType, Meta::TypeFactory& typeFactory);
 
     static bool hasClosedGenerics(const Meta::Type& type);
 
     std::pair<clang::Module*, std::vector<Meta::Meta*> >& _module;
-    Meta::TypeFactory& _typeFactory;
+    const BaseTypeArguments& _baseTypeArguments;
+    const InheritedMembers& _inheritedMembers;
     DocSetManager _docSet;
     std::unordered_set<std::string> _importedModules;
-    std::ostringstream _buffer;
+    llvm::raw_ostream* _output = nullptr;
 };
 }
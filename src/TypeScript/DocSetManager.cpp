@@ -3,9 +3,16 @@
 //
 
 #include "DocSetManager.h"
+#include "CommentDatabase.h"
+#include "Utils/Noncopyable.h"
+#include <libxml/parser.h>
 #include <libxml/xpath.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <mutex>
 #include <sstream>
-#include <unistd.h>
+#include <unordered_map>
 
 namespace {
 using namespace std;
@@ -44,11 +51,66 @@ void findAndReplaceIn(string& str, string searchFor, string replaceBy)
     };
 }
 
-xmlNodeSetPtr all(const xmlChar* xpath, xmlDocPtr doc, xmlXPathObjectPtr& result)
+// The XPath expressions used to extract the comments
+enum XPath {
+    AbstractXPath,
+    ParameterTermsXPath,
+    ParameterDiscussionsXPath,
+    FieldDiscussionsXPath,
+    XPathsCount
+};
+
+// Holds the compiled expressions and an evaluation context which is reused for all documents parsed on a thread
+class XPathEvaluator {
+    MAKE_NONCOPYABLE(XPathEvaluator);
+
+public:
+    XPathEvaluator()
+        : context(xmlXPathNewContext(nullptr))
+    {
+        static const char* xpaths[XPathsCount] = {
+            "/*/Abstract",
+            "/*/Parameters/Parameter/Term",
+            "/*/Parameters/Parameter/Discussion",
+            "/*/Fields/Field/Discussion"
+        };
+        for (int i = 0; i < XPathsCount; i++) {
+            expressions[i] = xmlXPathCompile(reinterpret_cast<const xmlChar*>(xpaths[i]));
+        }
+    }
+
+    ~XPathEvaluator()
+    {
+        for (xmlXPathCompExprPtr expression : expressions) {
+            xmlXPathFreeCompExpr(expression);
+        }
+        xmlXPathFreeContext(context);
+    }
+
+    static XPathEvaluator& forCurrentThread()
+    {
+        thread_local XPathEvaluator evaluator;
+        return evaluator;
+    }
+
+    xmlXPathObjectPtr evaluate(XPath xpath, xmlDocPtr doc)
+    {
+        context->doc = doc;
+        context->node = reinterpret_cast<xmlNodePtr>(doc);
+        return xmlXPathCompiledEval(expressions[xpath], context);
+    }
+
+private:
+    xmlXPathContextPtr context;
+    xmlXPathCompExprPtr expressions[XPathsCount];
+};
+
+xmlNodeSetPtr all(XPath xpath, xmlDocPtr doc, xmlXPathObjectPtr& result)
 {
-    xmlXPathContextPtr context = xmlXPathNewContext(doc);
-    result = xmlXPathEvalExpression(xpath, context);
-    xmlXPathFreeContext(context);
+    result = XPathEvaluator::forCurrentThread().evaluate(xpath, doc);
+    if (result == nullptr) {
+        return NULL;
+    }
     if (xmlXPathNodeSetIsEmpty(result->nodesetval)) {
         xmlXPathFreeObject(result);
         result = nullptr;
@@ -57,7 +119,7 @@ xmlNodeSetPtr all(const xmlChar* xpath, xmlDocPtr doc, xmlXPathObjectPtr& result
     return result->nodesetval;
 }
 
-xmlNodePtr first(const xmlChar* xpath, xmlDocPtr doc, xmlXPathObjectPtr& result)
+xmlNodePtr first(XPath xpath, xmlDocPtr doc, xmlXPathObjectPtr& result)
 {
     xmlNodeSetPtr nodes = all(xpath, doc, result);
     if (nodes && nodes->nodeNr > 0)
@@ -83,6 +145,28 @@ vector<string> innerTextOf(xmlNodeSetPtr xmlNodes, xmlDocPtr doc)
     }
     return result;
 }
+
+// Scans the Tokens directory of a docset once and shares the result between all managers using it
+shared_ptr<const TypeScript::DocSetManager::TokensIndex> getTokensIndex(const string& tokensPath)
+{
+    static mutex indexesMutex;
+    static unordered_map<string, shared_ptr<const TypeScript::DocSetManager::TokensIndex> > indexes;
+
+    lock_guard<mutex> lock(indexesMutex);
+    shared_ptr<const TypeScript::DocSetManager::TokensIndex>& index = indexes[tokensPath];
+    if (!index) {
+        shared_ptr<TypeScript::DocSetManager::TokensIndex> newIndex = make_shared<TypeScript::DocSetManager::TokensIndex>();
+        error_code error;
+        for (llvm::sys::fs::recursive_directory_iterator it(tokensPath, error), end; !error && it != end; it.increment(error)) {
+            const string& path = it->path();
+            if (llvm::sys::path::extension(path) == ".xml") {
+                newIndex->insert(path.substr(tokensPath.size() + 1));
+            }
+        }
+        index = newIndex;
+    }
+    return index;
+}
 }
 
 namespace TypeScript {
@@ -108,19 +192,59 @@ std::string TSComment::toString(std::string linePrefix)
     return result.str();
 }
 
+void DocSetManager::initializeParser()
+{
+    xmlInitParser();
+}
+
 TSComment DocSetManager::getCommentFor(Meta::Meta* meta, Meta::Meta* parent)
 {
     return (parent == nullptr) ? getCommentFor(meta->name, meta->type) : getCommentFor(meta->name, meta->type, parent->name, parent->type);
 }
 
+bool DocSetManager::getVersion(const std::string& docsetPath, uint64_t& version)
+{
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer> > infoPlist = llvm::MemoryBuffer::getFile(docsetPath + "/Contents/Info.plist");
+    if (!infoPlist) {
+        return false;
+    }
+    std::string versionData = docsetPath;
+    versionData += (*infoPlist)->getBuffer();
+
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : versionData) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    version = hash;
+    return true;
+}
+
 TSComment DocSetManager::getCommentFor(std::string name, Meta::MetaType type, std::string parentName, Meta::MetaType parentType)
+{
+    if (this->commentDatabase == nullptr) {
+        return this->parseCommentFor(name, type, parentName, parentType);
+    }
+
+    // Selectors contain ':' but none of the names contains '/'
+    std::string key = std::to_string(type) + "/" + std::to_string(parentType) + "/" + parentName + "/" + name;
+    TSComment comment;
+    if (!this->commentDatabase->find(key, comment)) {
+        comment = this->parseCommentFor(name, type, parentName, parentType);
+        this->commentDatabase->add(key, comment);
+    }
+    return comment;
+}
+
+TSComment DocSetManager::parseCommentFor(const std::string& name, Meta::MetaType type, const std::string& parentName, Meta::MetaType parentType)
 {
     xmlDocPtr doc = getXmlDocFileFor(name, type, parentName, parentType);
 
     TSComment comment;
     if (doc) {
         xmlXPathObjectPtr abstractNodeResult = nullptr;
-        xmlNodePtr abstractNode = first(reinterpret_cast<const xmlChar*>("/*/Abstract"), doc, abstractNodeResult);
+        xmlNodePtr abstractNode = first(AbstractXPath, doc, abstractNodeResult);
         if (abstractNode != nullptr) {
             std::string description = innerTextOf(abstractNode, doc);
             comment.description = trim(description);
@@ -130,10 +254,10 @@ TSComment DocSetManager::getCommentFor(std::string name, Meta::MetaType type, st
         case Meta::MetaType::Method:
         case Meta::MetaType::Function: {
             xmlXPathObjectPtr termNodesResult = nullptr;
-            std::vector<string> paramNames = innerTextOf(all(reinterpret_cast<const xmlChar*>("/*/Parameters/Parameter/Term"), doc, termNodesResult), doc);
+            std::vector<string> paramNames = innerTextOf(all(ParameterTermsXPath, doc, termNodesResult), doc);
             if (paramNames.size() > 0) {
                 xmlXPathObjectPtr discussionNodesResult = nullptr;
-                std::vector<string> paramDescs = innerTextOf(all(reinterpret_cast<const xmlChar*>("/*/Parameters/Parameter/Discussion"), doc, discussionNodesResult), doc);
+                std::vector<string> paramDescs = innerTextOf(all(ParameterDiscussionsXPath, doc, discussionNodesResult), doc);
                 assert(paramNames.size() == paramDescs.size());
 
                 for (size_t i = 0; i < paramNames.size(); i++) {
@@ -147,7 +271,7 @@ TSComment DocSetManager::getCommentFor(std::string name, Meta::MetaType type, st
         case Meta::MetaType::Struct:
         case Meta::MetaType::Union: {
             xmlXPathObjectPtr discussionNodesResult = nullptr;
-            std::vector<string> fieldsDescs = innerTextOf(all(reinterpret_cast<const xmlChar*>("/*/Fields/Field/Discussion"), doc, discussionNodesResult), doc);
+            std::vector<string> fieldsDescs = innerTextOf(all(FieldDiscussionsXPath, doc, discussionNodesResult), doc);
             if (fieldsDescs.size() > 0) {
                 for (size_t i = 0; i < fieldsDescs.size(); i++) {
                     TSComment fieldComment;
@@ -175,48 +299,48 @@ xmlDocPtr DocSetManager::getXmlDocFileFor(std::string name, Meta::MetaType type,
     std::vector<std::string> xmlPathCandidates;
     switch (type) {
     case Meta::MetaType::Struct: {
-        xmlPathCandidates.push_back(this->tokensPath + "/c/tdef/" + parent + "/" + name + ".xml");
-        xmlPathCandidates.push_back(this->tokensPath + "/c/tag/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("c/tdef/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("c/tag/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Function: {
-        xmlPathCandidates.push_back(this->tokensPath + "/c/func/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("c/func/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Enum: {
-        xmlPathCandidates.push_back(this->tokensPath + "/c/tdef/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("c/tdef/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::EnumConstant: {
-        xmlPathCandidates.push_back(this->tokensPath + "/c/econst/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("c/econst/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Var: {
-        xmlPathCandidates.push_back(this->tokensPath + "/c/data/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("c/data/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Interface: {
-        xmlPathCandidates.push_back(this->tokensPath + "/Objective-C/cl/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("Objective-C/cl/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Protocol: {
-        xmlPathCandidates.push_back(this->tokensPath + "/Objective-C/intf/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("Objective-C/intf/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Category: {
-        xmlPathCandidates.push_back(this->tokensPath + "/Objective-C/cat/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("Objective-C/cat/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Method: {
         std::string type1 = (parentType == Meta::MetaType::Interface) ? "instm" : "intfm";
         std::string type2 = (parentType == Meta::MetaType::Interface) ? "clm" : "intfcm";
-        xmlPathCandidates.push_back(this->tokensPath + "/Objective-C/" + type1 + "/" + parent + "/" + name + ".xml");
-        xmlPathCandidates.push_back(this->tokensPath + "/Objective-C/" + type2 + "/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("Objective-C/" + type1 + "/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("Objective-C/" + type2 + "/" + parent + "/" + name + ".xml");
         break;
     }
     case Meta::MetaType::Property: {
         std::string type = (parentType == Meta::MetaType::Interface) ? "instp" : "intfp";
-        xmlPathCandidates.push_back(this->tokensPath + "/Objective-C/" + type + "/" + parent + "/" + name + ".xml");
+        xmlPathCandidates.push_back("Objective-C/" + type + "/" + parent + "/" + name + ".xml");
         break;
     }
     default: {
@@ -224,9 +348,12 @@ xmlDocPtr DocSetManager::getXmlDocFileFor(std::string name, Meta::MetaType type,
     }
     }
 
+    if (!this->tokensIndex) {
+        this->tokensIndex = getTokensIndex(this->tokensPath);
+    }
     for (string& path : xmlPathCandidates) {
-        if (access(path.c_str(), F_OK) == 0) {
-            return xmlReadFile(path.c_str(), nullptr, 0);
+        if (this->tokensIndex->find(path) != this->tokensIndex->end()) {
+            return xmlReadFile((this->tokensPath + "/" + path).c_str(), nullptr, 0);
         }
     }
     return nullptr;
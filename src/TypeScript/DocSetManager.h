@@ -6,6 +6,9 @@
 #define METADATAGENERATOR_DOCSETPARSER_H
 
 #include <Meta/MetaEntities.h>
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
 
 struct _xmlDoc;
 
@@ -14,6 +17,7 @@ class Meta;
 }
 
 namespace TypeScript {
+class CommentDatabase;
 
 // \brief A structure, representing a TypeScript comment.
 struct TSComment {
@@ -44,12 +48,27 @@ struct TSComment {
  */
 class DocSetManager {
 public:
-    DocSetManager(std::string docsetPath)
+    // The paths of the documentation files in the Tokens directory, relative to it
+    typedef std::unordered_set<std::string> TokensIndex;
+
+    DocSetManager(std::string docsetPath, CommentDatabase* commentDatabase = nullptr)
         : docsetPath(docsetPath)
         , tokensPath(docsetPath + "/Contents/Resources/Tokens")
+        , commentDatabase(commentDatabase)
     {
     }
 
+    /*
+     * \brief Gets a hash of the docset's path and Info.plist, which changes with the version of the docset.
+     * Returns false if the docset has no Info.plist, in which case its version can't be told.
+     */
+    static bool getVersion(const std::string& docsetPath, uint64_t& version);
+
+    /*
+     * \brief Initializes the XML parser. Must be called on the main thread before comments are retrieved concurrently.
+     */
+    static void initializeParser();
+
     /*
      * \brief Retrieves a TypeScript comment for a given symbol. If the symbol is a member (e.g. method or property) a parent must be supplied, too.
      * \param meta The symbol for which TypeScript comment will be generated.
@@ -60,6 +79,11 @@ public:
     TSComment getCommentFor(std::string name, Meta::MetaType type, std::string parentName = "", Meta::MetaType parentType = Meta::MetaType::Undefined);
 
 private:
+    /*
+     * \brief Extracts the comment for a symbol from its XML documentation file.
+     */
+    TSComment parseCommentFor(const std::string& name, Meta::MetaType type, const std::string& parentName, Meta::MetaType parentType);
+
     /*
      * \brief Tries to find the location and parses the XML documentation file for a symbol with the given name and type. Null is returned if unable to find a doc file.
      * \param name The name of the symbol.
@@ -71,6 +95,10 @@ private:
 
     std::string docsetPath;
     std::string tokensPath;
+    // Loaded on first use, so that a docset is not scanned unless comments are requested
+    std::shared_ptr<const TokensIndex> tokensIndex;
+    // Optional, comments found in it are not parsed again
+    CommentDatabase* commentDatabase;
 };
 }
 
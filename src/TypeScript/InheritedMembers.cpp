@@ -0,0 +1,53 @@
+#include "InheritedMembers.h"
+#include <cassert>
+
+namespace TypeScript {
+using namespace Meta;
+
+InheritedMembers::InheritedMembers(const ClassHierarchy& hierarchy)
+{
+    // Everything a class refers to precedes it, so the parents' tables are always complete
+    for (BaseClassMeta* meta : hierarchy.getTopologicalOrder()) {
+        if (meta->is(MetaType::Protocol)) {
+            ProtocolMeta* protocol = &meta->as<ProtocolMeta>();
+            CompoundMemberMap<MethodMeta>& staticMethods = _protocolStaticMethods[protocol];
+            addOwnMethods(staticMethods, protocol);
+            for (ProtocolMeta* adoptedProtocol : protocol->protocols) {
+                merge(staticMethods, _protocolStaticMethods[adoptedProtocol]);
+            }
+        } else if (meta->is(MetaType::Interface)) {
+            InterfaceMeta* interface = &meta->as<InterfaceMeta>();
+            CompoundMemberMap<MethodMeta>& staticMethods = _inheritedStaticMethods[interface];
+            if (InterfaceMeta* base = interface->base) {
+                addOwnMethods(staticMethods, base);
+                for (ProtocolMeta* protocol : base->protocols) {
+                    merge(staticMethods, _protocolStaticMethods[protocol]);
+                }
+                merge(staticMethods, _inheritedStaticMethods[base]);
+            }
+        }
+    }
+}
+
+const CompoundMemberMap<MethodMeta>& InheritedMembers::getStaticMethods(InterfaceMeta* interface) const
+{
+    std::unordered_map<InterfaceMeta*, CompoundMemberMap<MethodMeta> >::const_iterator it = _inheritedStaticMethods.find(interface);
+    assert(it != _inheritedStaticMethods.end());
+    return it->second;
+}
+
+void InheritedMembers::merge(CompoundMemberMap<MethodMeta>& to, const CompoundMemberMap<MethodMeta>& methods)
+{
+    // Members which are already in the table take precedence
+    for (const CompoundMemberMap<MethodMeta>::value_type& methodPair : methods) {
+        to.insert(methodPair);
+    }
+}
+
+void InheritedMembers::addOwnMethods(CompoundMemberMap<MethodMeta>& to, BaseClassMeta* owner)
+{
+    for (MethodMeta* method : owner->staticMethods) {
+        to.emplace(method->jsName, std::make_pair(owner, method));
+    }
+}
+}
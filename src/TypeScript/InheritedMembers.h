@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Meta/ClassHierarchy.h"
+#include "Meta/MetaEntities.h"
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace TypeScript {
+// Members by JS name, each one along with the class which declares it
+template <class Member>
+using CompoundMemberMap = std::map<std::string, std::pair<Meta::BaseClassMeta*, Member*> >;
+
+/*
+ * \class InheritedMembers
+ * \brief Holds the static methods each interface inherits from its base classes and their protocols.
+ *
+ * The tables are flattened once in base-to-derived order when the metas are final and are shared
+ * (read only) by the definition writers of all modules.
+ */
+class InheritedMembers {
+public:
+    explicit InheritedMembers(const Meta::ClassHierarchy& hierarchy);
+
+    // The first class in lookup order (see ClassHierarchy::getInheritedClasses) which declares a method with a given name wins
+    const CompoundMemberMap<Meta::MethodMeta>& getStaticMethods(Meta::InterfaceMeta* interface) const;
+
+private:
+    static void merge(CompoundMemberMap<Meta::MethodMeta>& to, const CompoundMemberMap<Meta::MethodMeta>& methods);
+
+    static void addOwnMethods(CompoundMemberMap<Meta::MethodMeta>& to, Meta::BaseClassMeta* owner);
+
+    // The protocol's own static methods followed by the ones of the protocols it adopts (depth first)
+    std::unordered_map<Meta::ProtocolMeta*, CompoundMemberMap<Meta::MethodMeta> > _protocolStaticMethods;
+    std::unordered_map<Meta::InterfaceMeta*, CompoundMemberMap<Meta::MethodMeta> > _inheritedStaticMethods;
+};
+}
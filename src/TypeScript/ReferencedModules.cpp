@@ -0,0 +1,150 @@
+#include "ReferencedModules.h"
+#include <clang/AST/DeclObjC.h>
+
+namespace TypeScript {
+using namespace Meta;
+
+void ReferencedModules::addReferencesOf(const std::vector< ::Meta::Meta*>& metas)
+{
+    for (const ::Meta::Meta* meta : metas) {
+        this->addReferencesOf(*meta);
+    }
+}
+
+void ReferencedModules::addReferencesOf(const ::Meta::Meta& meta)
+{
+    switch (meta.type) {
+    case MetaType::Interface:
+    case MetaType::Protocol:
+    case MetaType::Category: {
+        const BaseClassMeta& baseClass = meta.as<BaseClassMeta>();
+        if (meta.is(MetaType::Interface) && meta.as<InterfaceMeta>().base != nullptr) {
+            this->addModuleOf(*meta.as<InterfaceMeta>().base);
+            // Written as 'extends Base<TypeArguments>'
+            if (const clang::ObjCObjectType* superClassType = clang::cast<clang::ObjCInterfaceDecl>(meta.declaration)->getSuperClassType()) {
+                for (const clang::QualType& typeArgument : superClassType->getTypeArgsAsWritten()) {
+                    CreationResult<std::shared_ptr<Type> > type = _typeFactory.create(typeArgument);
+                    if (type) {
+                        this->addReferencesOf(*type.getValue());
+                    }
+                }
+            }
+        }
+        for (const ProtocolMeta* protocol : baseClass.protocols) {
+            this->addModuleOf(*protocol);
+        }
+        for (const std::vector<MethodMeta*>* methods : { &baseClass.instanceMethods, &baseClass.staticMethods }) {
+            for (const MethodMeta* method : *methods) {
+                this->addReferencesOf(method->signature);
+            }
+        }
+        for (const std::vector<PropertyMeta*>* properties : { &baseClass.instanceProperties, &baseClass.staticProperties }) {
+            for (const PropertyMeta* property : *properties) {
+                if (property->getter) {
+                    this->addReferencesOf(property->getter->signature);
+                }
+                if (property->setter) {
+                    this->addReferencesOf(property->setter->signature);
+                }
+            }
+        }
+        break;
+    }
+    case MetaType::Struct:
+    case MetaType::Union:
+        for (const RecordField& field : meta.as<RecordMeta>().fields) {
+            this->addReferencesOf(*field.encoding);
+        }
+        break;
+    case MetaType::Function:
+        this->addReferencesOf(meta.as<FunctionMeta>().signature);
+        break;
+    case MetaType::Var:
+        this->addReferencesOf(*meta.as<VarMeta>().signature);
+        break;
+    default:
+        break;
+    }
+}
+
+void ReferencedModules::addReferencesOf(const std::vector<Type*>& signature)
+{
+    for (const Type* type : signature) {
+        this->addReferencesOf(*type);
+    }
+}
+
+void ReferencedModules::addReferencesOf(const Type& type)
+{
+    switch (type.getType()) {
+    case TypeClass:
+        // Written as 'typeof NSObject'
+        _moduleNames.insert("ObjectiveC");
+        break;
+    case TypeId:
+        for (const ProtocolMeta* protocol : type.as<IdType>().protocols) {
+            this->addModuleOf(*protocol);
+        }
+        break;
+    case TypeConstantArray:
+        this->addReferencesOf(*type.as<ConstantArrayType>().innerType);
+        break;
+    case TypeExtVector:
+        this->addReferencesOf(*type.as<ExtVectorType>().innerType);
+        break;
+    case TypeIncompleteArray:
+        this->addReferencesOf(*type.as<IncompleteArrayType>().innerType);
+        break;
+    case TypePointer:
+        this->addReferencesOf(*type.as<PointerType>().innerType);
+        break;
+    case TypeBlock:
+        this->addReferencesOf(type.as<BlockType>().signature);
+        break;
+    case TypeFunctionPointer:
+        this->addReferencesOf(type.as<FunctionPointerType>().signature);
+        break;
+    case TypeInterface: {
+        const InterfaceType& interfaceType = type.as<InterfaceType>();
+        this->addModuleOf(*interfaceType.interface);
+        this->addReferencesOf(interfaceType.typeArguments);
+        break;
+    }
+    case TypeBridgedInterface: {
+        const BridgedInterfaceType& bridgedType = type.as<BridgedInterfaceType>();
+        if (bridgedType.bridgedInterface != nullptr) {
+            this->addModuleOf(*bridgedType.bridgedInterface);
+        }
+        break;
+    }
+    case TypeStruct:
+        this->addModuleOf(*type.as<StructType>().structMeta);
+        break;
+    case TypeUnion:
+        this->addModuleOf(*type.as<UnionType>().unionMeta);
+        break;
+    case TypeAnonymousStruct:
+        for (const RecordField& field : type.as<AnonymousStructType>().fields) {
+            this->addReferencesOf(*field.encoding);
+        }
+        break;
+    case TypeAnonymousUnion:
+        for (const RecordField& field : type.as<AnonymousUnionType>().fields) {
+            this->addReferencesOf(*field.encoding);
+        }
+        break;
+    case TypeEnum:
+        this->addModuleOf(*type.as<EnumType>().enumMeta);
+        break;
+    default:
+        break;
+    }
+}
+
+void ReferencedModules::addModuleOf(const ::Meta::Meta& meta)
+{
+    if (meta.module != nullptr) {
+        _moduleNames.insert(meta.module->getTopLevelModule()->getFullModuleName());
+    }
+}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Meta/MetaEntities.h"
+#include "Meta/TypeFactory.h"
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace TypeScript {
+/*
+ * \class ReferencedModules
+ * \brief Collects the names of the top level modules whose declarations the definitions of a set of metas refer to.
+ *
+ * Only direct references are collected (base classes and their type arguments, protocols and the types in signatures
+ * and fields). Anything the definitions get from a base class or a protocol is found by collecting the references of its module.
+ * The types of the base type arguments are created through the type factory, so this can't be used concurrently with it.
+ */
+class ReferencedModules {
+public:
+    explicit ReferencedModules(Meta::TypeFactory& typeFactory)
+        : _typeFactory(typeFactory)
+    {
+    }
+
+    void addReferencesOf(const std::vector<Meta::Meta*>& metas);
+
+    const std::unordered_set<std::string>& getModuleNames() const
+    {
+        return _moduleNames;
+    }
+
+private:
+    void addReferencesOf(const Meta::Meta& meta);
+
+    void addReferencesOf(const Meta::Type& type);
+
+    void addReferencesOf(const std::vector<Meta::Type*>& signature);
+
+    void addModuleOf(const Meta::Meta& meta);
+
+    Meta::TypeFactory& _typeFactory;
+    std::unordered_set<std::string> _moduleNames;
+};
+}
@@ -0,0 +1,179 @@
+#include "Logger.h"
+#include <cstdio>
+#include <iostream>
+
+static const char* levelName(utils::LogLevel level)
+{
+    switch (level) {
+    case utils::LogLevel::Error:
+        return "error";
+    case utils::LogLevel::Info:
+        return "info";
+    case utils::LogLevel::Verbose:
+        return "verbose";
+    }
+    return "";
+}
+
+static void appendJsonString(const std::string& value, std::string& output)
+{
+    output += '"';
+    for (char c : value) {
+        switch (c) {
+        case '"':
+            output += "\\\"";
+            break;
+        case '\\':
+            output += "\\\\";
+            break;
+        case '\n':
+            output += "\\n";
+            break;
+        case '\r':
+            output += "\\r";
+            break;
+        case '\t':
+            output += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[7];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                output += escaped;
+            } else {
+                output += c;
+            }
+        }
+    }
+    output += '"';
+}
+
+utils::Logger& utils::Logger::get()
+{
+    static Logger logger;
+    return logger;
+}
+
+utils::Logger::~Logger()
+{
+    this->stop();
+}
+
+void utils::Logger::start(LogLevel level, Format format)
+{
+    this->stop();
+    _level = level;
+    _format = format;
+    _isStopping = false;
+    _isRunning = true;
+    _thread = std::thread(&Logger::run, this);
+}
+
+void utils::Logger::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_isRunning) {
+            return;
+        }
+        // Entries logged from now on are written right away, the thread drains the ones which are already pending
+        _isRunning = false;
+        _isStopping = true;
+    }
+    _condition.notify_one();
+    _thread.join();
+}
+
+void utils::Logger::log(LogLevel level, std::string message, Fields fields)
+{
+    if (!this->isEnabled(level)) {
+        return;
+    }
+
+    Entry entry{ level, std::move(message), std::move(fields) };
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_isRunning) {
+            _pending.push_back(std::move(entry));
+            _condition.notify_one();
+            return;
+        }
+    }
+
+    // Not started yet, write the message right away
+    this->write(std::vector<Entry>{ std::move(entry) });
+}
+
+bool utils::Logger::parseFormat(const std::string& name, Format& format)
+{
+    if (name == "text") {
+        format = Format::Text;
+        return true;
+    }
+    if (name == "json") {
+        format = Format::JsonLines;
+        return true;
+    }
+    return false;
+}
+
+void utils::Logger::run()
+{
+    std::vector<Entry> entries;
+    while (true) {
+        bool isStopping;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]() { return !_pending.empty() || _isStopping; });
+            entries.swap(_pending);
+            isStopping = _isStopping;
+        }
+
+        this->write(entries);
+        entries.clear();
+
+        if (isStopping) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_pending.empty()) {
+                return;
+            }
+        }
+    }
+}
+
+void utils::Logger::write(const std::vector<Entry>& entries)
+{
+    if (entries.empty()) {
+        return;
+    }
+
+    std::string output;
+    for (const Entry& entry : entries) {
+        this->format(entry, output);
+    }
+    std::cerr.write(output.data(), output.size());
+    std::cerr.flush();
+}
+
+void utils::Logger::format(const Entry& entry, std::string& output) const
+{
+    if (_format == Format::Text) {
+        output += levelName(entry.level);
+        output += ": ";
+        output += entry.message;
+        output += '\n';
+        return;
+    }
+
+    output += "{\"level\":";
+    appendJsonString(levelName(entry.level), output);
+    output += ",\"message\":";
+    appendJsonString(entry.message, output);
+    for (const std::pair<const char*, std::string>& field : entry.fields) {
+        output += ',';
+        appendJsonString(field.first, output);
+        output += ':';
+        appendJsonString(field.second, output);
+    }
+    output += "}\n";
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Noncopyable.h"
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace utils {
+enum class LogLevel {
+    Error = 0,
+    Info,
+    Verbose
+};
+
+/*
+ * \class Logger
+ * \brief Writes diagnostic messages to the standard error stream.
+ *
+ * Callers check \c isEnabled before composing a message, so disabled levels cost nothing.
+ * Once started, messages are queued and written in batches by a background thread either as
+ * plain text lines ("verbose: <message>") or as JSON lines which include the message fields.
+ */
+class Logger {
+    MAKE_NONCOPYABLE(Logger);
+
+public:
+    enum class Format {
+        Text,
+        JsonLines
+    };
+
+    typedef std::vector<std::pair<const char*, std::string> > Fields;
+
+    static Logger& get();
+
+    ~Logger();
+
+    // Must be called before any other thread uses the logger
+    void start(LogLevel level, Format format);
+
+    // Writes all queued messages and stops the background thread
+    void stop();
+
+    bool isEnabled(LogLevel level) const
+    {
+        return level <= _level;
+    }
+
+    void log(LogLevel level, std::string message, Fields fields = Fields());
+
+    static bool parseFormat(const std::string& name, Format& format);
+
+private:
+    struct Entry {
+        LogLevel level;
+        std::string message;
+        Fields fields;
+    };
+
+    Logger() = default;
+
+    void run();
+
+    void write(const std::vector<Entry>& entries);
+
+    void format(const Entry& entry, std::string& output) const;
+
+    LogLevel _level = LogLevel::Error;
+    Format _format = Format::Text;
+
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::vector<Entry> _pending;
+    bool _isRunning = false;
+    bool _isStopping = false;
+    std::thread _thread;
+};
+}
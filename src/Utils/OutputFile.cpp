@@ -0,0 +1,130 @@
+#include "OutputFile.h"
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <llvm/Support/FileSystem.h>
+#include <sys/stat.h>
+
+utils::OutputFile::OutputFile(const std::string& path)
+    : _stream(*this)
+{
+    // Write through symbolic links instead of replacing them
+    char resolvedPath[PATH_MAX];
+    _path = (realpath(path.c_str(), resolvedPath) != nullptr) ? std::string(resolvedPath) : path;
+
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer> > existingFile = llvm::MemoryBuffer::getFile(_path, /*FileSize*/ -1, /*RequiresNullTerminator*/ false);
+    if (existingFile) {
+        _existingFile = std::move(*existingFile);
+    }
+}
+
+utils::OutputFile::~OutputFile()
+{
+    if (!_isClosed) {
+        _isClosed = true;
+        this->removeTemporaryFile();
+    }
+}
+
+void utils::OutputFile::append(const char* data, size_t size)
+{
+    if (_isClosed || _error) {
+        return;
+    }
+
+    if (!_temporaryFile) {
+        // The content is still the same as the beginning of the existing file
+        llvm::StringRef remainingContent = _existingFile ? _existingFile->getBuffer().drop_front(_size) : llvm::StringRef();
+        if (size <= remainingContent.size() && memcmp(data, remainingContent.data(), size) == 0) {
+            _size += size;
+            return;
+        }
+
+        size_t matchingSize = 0;
+        while (matchingSize < size && matchingSize < remainingContent.size() && data[matchingSize] == remainingContent[matchingSize]) {
+            matchingSize++;
+        }
+        _size += matchingSize;
+        data += matchingSize;
+        size -= matchingSize;
+
+        _error = this->openTemporaryFile();
+        if (_error) {
+            return;
+        }
+    }
+
+    _temporaryFile->write(data, size);
+    _size += size;
+}
+
+std::error_code utils::OutputFile::openTemporaryFile()
+{
+    int fd;
+    if (std::error_code error = llvm::sys::fs::createUniqueFile(llvm::Twine(_path) + ".%%%%%%.tmp", fd, _temporaryPath)) {
+        return error;
+    }
+
+    struct stat existingFileStatus;
+    if (_existingFile && stat(_path.c_str(), &existingFileStatus) == 0) {
+        fchmod(fd, existingFileStatus.st_mode & 07777);
+    }
+
+    _temporaryFile.reset(new llvm::raw_fd_ostream(fd, /*shouldClose*/ true));
+    if (_size > 0) {
+        _temporaryFile->write(_existingFile->getBufferStart(), _size);
+    }
+    return std::error_code();
+}
+
+void utils::OutputFile::removeTemporaryFile()
+{
+    if (_temporaryFile) {
+        _temporaryFile->clear_error();
+        _temporaryFile.reset();
+        llvm::sys::fs::remove(_temporaryPath);
+    }
+}
+
+std::error_code utils::OutputFile::close()
+{
+    _stream.flush();
+    _isClosed = true;
+    if (_error) {
+        this->removeTemporaryFile();
+        return _error;
+    }
+
+    if (!_temporaryFile) {
+        if (_existingFile && _size == _existingFile->getBufferSize()) {
+            return std::error_code();
+        }
+
+        // There is no file yet or the content is shorter than the existing one
+        if (std::error_code error = this->openTemporaryFile()) {
+            return error;
+        }
+    }
+
+    _temporaryFile->close();
+    if (_temporaryFile->has_error()) {
+        this->removeTemporaryFile();
+        return std::make_error_code(std::errc::io_error);
+    }
+    _temporaryFile.reset();
+
+    // The existing file is unmapped before it gets replaced
+    _existingFile.reset();
+    if (std::error_code error = llvm::sys::fs::rename(_temporaryPath, _path)) {
+        llvm::sys::fs::remove(_temporaryPath);
+        return error;
+    }
+    return std::error_code();
+}
+
+std::error_code utils::OutputFile::write(const std::string& path, llvm::StringRef content)
+{
+    OutputFile file(path);
+    file.stream() << content;
+    return file.close();
+}
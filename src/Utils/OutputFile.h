@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Noncopyable.h"
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <memory>
+#include <string>
+#include <system_error>
+
+namespace utils {
+/*
+ * \class OutputFile
+ * \brief Writes a generated file only if its content differs from the existing file.
+ *
+ * The streamed content is compared with a mapped copy of the existing file and nothing is written up to the first
+ * differing byte. From there on the content goes to a temporary file, which is renamed over the old one by \c close.
+ * Unchanged files keep their modification time, so that the tools which consume them don't treat them as dirty.
+ * Symbolic links are followed and the replaced file's permissions are kept, but other hard links to it are not updated.
+ */
+class OutputFile {
+    MAKE_NONCOPYABLE(OutputFile);
+
+public:
+    explicit OutputFile(const std::string& path);
+
+    // Removes the temporary file if the output file hasn't been closed
+    ~OutputFile();
+
+    llvm::raw_ostream& stream()
+    {
+        return _stream;
+    }
+
+    std::error_code close();
+
+    static std::error_code write(const std::string& path, llvm::StringRef content);
+
+private:
+    class Stream : public llvm::raw_ostream {
+    public:
+        explicit Stream(OutputFile& file)
+            : _file(file)
+        {
+        }
+
+        virtual ~Stream() override
+        {
+            this->flush();
+        }
+
+    private:
+        virtual void write_impl(const char* data, size_t size) override
+        {
+            _file.append(data, size);
+        }
+
+        virtual uint64_t current_pos() const override
+        {
+            return _file._size;
+        }
+
+        OutputFile& _file;
+    };
+
+    void append(const char* data, size_t size);
+
+    // Opens the temporary file and copies the part of the existing file which has been streamed so far into it
+    std::error_code openTemporaryFile();
+
+    void removeTemporaryFile();
+
+    std::string _path;
+    std::unique_ptr<llvm::MemoryBuffer> _existingFile;
+    // The size of the content streamed so far
+    uint64_t _size = 0;
+    llvm::SmallString<128> _temporaryPath;
+    std::unique_ptr<llvm::raw_fd_ostream> _temporaryFile;
+    std::error_code _error;
+    bool _isClosed = false;
+    Stream _stream;
+};
+}
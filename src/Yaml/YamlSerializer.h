@@ -1,6 +1,7 @@
 #pragma once
 
 #include "MetaYamlTraits.h"
+#include "Utils/OutputFile.h"
 #include <llvm/Support/FileSystem.h>
 #include <string>
 
@@ -10,13 +11,13 @@ public:
     template <class T>
     static void serialize(std::string outputFilePath, T& object)
     {
-        std::error_code errorCode;
-        llvm::raw_fd_ostream fileStream(outputFilePath, errorCode, llvm::sys::fs::OpenFlags::F_None);
-        if (errorCode)
-            throw std::runtime_error(std::string("Unable to open file ") + outputFilePath + ".");
-        llvm::yaml::Output output(fileStream);
-        output << object;
-        fileStream.close();
+        utils::OutputFile file(outputFilePath);
+        {
+            llvm::yaml::Output output(file.stream());
+            output << object;
+        }
+        if (file.close())
+            throw std::runtime_error(std::string("Unable to write file ") + outputFilePath + ".");
     }
 };
 }
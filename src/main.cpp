@@ -1,25 +1,35 @@
 #include "Binary/binarySerializer.h"
 #include "HeadersParser/Parser.h"
 #include "Meta/DeclarationConverterVisitor.h"
-#include "Meta/Filters/HandleExceptionalMetasFilter.h"
-#include "Meta/Filters/HandleMethodsAndPropertiesWithSameNameFilter.h"
-#include "Meta/Filters/MergeCategoriesFilter.h"
+#include "Meta/Filters/FilterPipeline.h"
 #include "Meta/Filters/ModulesBlacklist.h"
-#include "Meta/Filters/RemoveDuplicateMembersFilter.h"
 #include "Meta/Filters/ResolveGlobalNamesCollisionsFilter.h"
+#include "Meta/SymbolIndex.h"
+#include "TypeScript/CommentDatabase.h"
 #include "TypeScript/DefinitionWriter.h"
 #include "TypeScript/DocSetManager.h"
+#include "TypeScript/ReferencedModules.h"
+#include "Utils/Logger.h"
+#include "Utils/OutputFile.h"
 #include "Yaml/YamlSerializer.h"
+#include <algorithm>
+#include <atomic>
 #include <clang/Frontend/CompilerInstance.h>
 #include <clang/Tooling/Tooling.h>
 #include <fstream>
+#include <future>
 #include <llvm/Support/Debug.h>
 #include <llvm/Support/Path.h>
 #include <pwd.h>
 #include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 // Command line parameters
 llvm::cl::opt<bool>   cla_verbose("verbose", llvm::cl::desc("Set verbose output mode"), llvm::cl::value_desc("bool"));
+llvm::cl::opt<string> cla_verboseFormat("verbose-format", llvm::cl::desc("Specify the format of verbose output: 'text' (default) or 'json' for JSON lines"), llvm::cl::value_desc("text|json"), llvm::cl::init("text"));
 llvm::cl::opt<bool>   cla_strictIncludes("strict-includes", llvm::cl::desc("Set strict include headers for diagnostic purposes (usually when some metadata is not generated due to wrong import or include statement)"), llvm::cl::value_desc("bool"));
 llvm::cl::opt<string> cla_outputUmbrellaHeaderFile("output-umbrella", llvm::cl::desc("Specify the output umbrella header file"), llvm::cl::value_desc("file_path"));
 llvm::cl::opt<string> cla_inputUmbrellaHeaderFile("input-umbrella", llvm::cl::desc("Specify the input umbrella header file"), llvm::cl::value_desc("file_path"));
@@ -27,18 +37,78 @@ llvm::cl::opt<string> cla_outputYamlFolder("output-yaml", llvm::cl::desc("Specif
 llvm::cl::opt<string> cla_outputModuleMapsFolder("output-modulemaps", llvm::cl::desc("Specify the fodler where modulemap files of all parsed modules will be dumped"), llvm::cl::value_desc("<dir_path>"));
 llvm::cl::opt<string> cla_outputBinFile("output-bin", llvm::cl::desc("Specify the output binary metadata file"), llvm::cl::value_desc("<file_path>"));
 llvm::cl::opt<string> cla_outputDtsFolder("output-typescript", llvm::cl::desc("Specify the output .d.ts folder"), llvm::cl::value_desc("<dir_path>"));
+llvm::cl::list<string> cla_typeScriptModules("typescript-modules", llvm::cl::desc("Specify the modules to generate .d.ts files for. The modules they refer to are generated too. All modules are generated if neither modules nor symbols are specified"), llvm::cl::value_desc("module names"), llvm::cl::CommaSeparated);
+llvm::cl::list<string> cla_typeScriptSymbols("typescript-symbols", llvm::cl::desc("Specify symbols whose modules to generate .d.ts files for, in addition to the ones specified by -typescript-modules"), llvm::cl::value_desc("symbol names"), llvm::cl::CommaSeparated);
 llvm::cl::opt<string> cla_docSetFile("docset-path", llvm::cl::desc("Specify the path to the iOS SDK docset package"), llvm::cl::value_desc("<file_path>"));
+llvm::cl::opt<string> cla_docSetCacheFile("docset-cache-file", llvm::cl::desc("Specify a file in which the comments extracted from the docset are kept between runs"), llvm::cl::value_desc("<file_path>"));
 llvm::cl::opt<string> cla_blackListModuleRegexesFile("blacklist-modules-file", llvm::cl::desc("Specify the metadata entries blacklist file containing regexes of module names on each line"), llvm::cl::value_desc("file_path"));
 llvm::cl::opt<string> cla_whiteListModuleRegexesFile("whitelist-modules-file", llvm::cl::desc("Specify the metadata entries whitelist file containing regexes of module names on each line"), llvm::cl::value_desc("file_path"));
 llvm::cl::opt<bool>   cla_applyManualDtsChanges("apply-manual-dts-changes", llvm::cl::desc("Specify whether to disable manual adjustments to generated .d.ts files for specific erroneous cases in the iOS SDK"), llvm::cl::init(true));
 llvm::cl::opt<string> cla_clangArgumentsDelimiter(llvm::cl::Positional, llvm::cl::desc("Xclang"), llvm::cl::init("-"));
 llvm::cl::list<string> cla_clangArguments(llvm::cl::ConsumeAfter, llvm::cl::desc("<clang arguments>..."));
 
+// The top level modules which declare the requested symbols, looked up by name or JS name
+static std::vector<std::string> getModulesOfSymbols(Meta::ResolveGlobalNamesCollisionsFilter::MetasByModules& metasByModules, const std::vector<std::string>& symbols)
+{
+    std::unordered_set<std::string> remainingSymbols(symbols.begin(), symbols.end());
+    std::vector<std::string> moduleNames;
+    for (std::pair<clang::Module*, std::vector<Meta::Meta*> >& modulePair : metasByModules) {
+        for (Meta::Meta* meta : modulePair.second) {
+            if (remainingSymbols.erase(meta->name) + remainingSymbols.erase(meta->jsName) > 0) {
+                moduleNames.push_back(modulePair.first->getFullModuleName());
+            }
+        }
+    }
+
+    for (const std::string& symbol : remainingSymbols) {
+        std::cout << "Requested symbol " << symbol << " not found" << std::endl;
+    }
+    return moduleNames;
+}
+
+// The requested modules and all modules their definitions refer to, directly or through other modules. The definitions of each
+// module are written independently, so the files written for them are the same as the ones written for all modules.
+static std::vector<std::pair<clang::Module*, std::vector<Meta::Meta*> >*> getReferencedModulesClosure(Meta::ResolveGlobalNamesCollisionsFilter::MetasByModules& metasByModules, const std::vector<std::string>& requestedModules, Meta::TypeFactory& typeFactory)
+{
+    std::unordered_map<std::string, std::pair<clang::Module*, std::vector<Meta::Meta*> >*> modulesByName;
+    for (std::pair<clang::Module*, std::vector<Meta::Meta*> >& modulePair : metasByModules) {
+        modulesByName[modulePair.first->getFullModuleName()] = &modulePair;
+    }
+
+    for (const std::string& moduleName : requestedModules) {
+        if (modulesByName.find(moduleName) == modulesByName.end()) {
+            std::cout << "No declarations found in requested module " << moduleName << std::endl;
+        }
+    }
+
+    std::vector<std::pair<clang::Module*, std::vector<Meta::Meta*> >*> closure;
+    std::unordered_set<std::string> visitedModules;
+    std::vector<std::string> pendingModules(requestedModules.begin(), requestedModules.end());
+    while (!pendingModules.empty()) {
+        std::string moduleName = pendingModules.back();
+        pendingModules.pop_back();
+        if (!visitedModules.insert(moduleName).second) {
+            continue;
+        }
+
+        std::unordered_map<std::string, std::pair<clang::Module*, std::vector<Meta::Meta*> >*>::const_iterator it = modulesByName.find(moduleName);
+        if (it == modulesByName.end()) {
+            continue;
+        }
+        closure.push_back(it->second);
+
+        TypeScript::ReferencedModules referencedModules(typeFactory);
+        referencedModules.addReferencesOf(it->second->second);
+        pendingModules.insert(pendingModules.end(), referencedModules.getModuleNames().begin(), referencedModules.getModuleNames().end());
+    }
+    return closure;
+}
+
 class MetaGenerationConsumer : public clang::ASTConsumer {
 public:
     explicit MetaGenerationConsumer(clang::SourceManager& sourceManager, clang::HeaderSearch& headerSearch, Meta::ModulesBlacklist& modulesBlacklist)
         : _headerSearch(headerSearch)
-        , _visitor(sourceManager, _headerSearch, cla_verbose, modulesBlacklist)
+        , _visitor(sourceManager, _headerSearch, modulesBlacklist)
     {
     }
 
@@ -47,19 +117,17 @@ public:
         Context.getDiagnostics().Reset();
         llvm::SmallVector<clang::Module*, 64> modules;
         _headerSearch.collectAllModules(modules);
-        std::list<Meta::Meta*>& metaContainer = _visitor.generateMetadata(Context.getTranslationUnitDecl());
+        Meta::MetaContainer& metaContainer = _visitor.generateMetadata(Context.getTranslationUnitDecl());
+        Meta::SymbolIndex symbolIndex(metaContainer);
 
         // Filters
-        Meta::HandleExceptionalMetasFilter().filter(metaContainer);
-        Meta::MergeCategoriesFilter().filter(metaContainer);
-        Meta::RemoveDuplicateMembersFilter().filter(metaContainer);
-        Meta::HandleMethodsAndPropertiesWithSameNameFilter(_visitor.getMetaFactory()).filter(metaContainer);
         Meta::ResolveGlobalNamesCollisionsFilter filter = Meta::ResolveGlobalNamesCollisionsFilter();
-        filter.filter(metaContainer);
+        Meta::FilterPipeline::createDefault(_visitor.getMetaFactory(), symbolIndex, filter).run(metaContainer);
         std::unique_ptr<std::pair<Meta::ResolveGlobalNamesCollisionsFilter::MetasByModules, Meta::ResolveGlobalNamesCollisionsFilter::InterfacesByName> > result = filter.getResult();
         Meta::ResolveGlobalNamesCollisionsFilter::MetasByModules& metasByModules = result->first;
         Meta::ResolveGlobalNamesCollisionsFilter::InterfacesByName& interfacesByName = result->second;
         _visitor.getMetaFactory().getTypeFactory().resolveCachedBridgedInterfaceTypes(interfacesByName);
+        _visitor.getMetaFactory().freeze();
 
         // Log statistic for parsed Meta objects
         std::cout << "Result: " << metaContainer.size() << " declarations from " << metasByModules.size() << " top level modules" << std::endl;
@@ -69,14 +137,11 @@ public:
             llvm::sys::fs::create_directories(cla_outputModuleMapsFolder);
             for (clang::Module*& module : modules) {
                 std::string filePath = std::string(cla_outputModuleMapsFolder) + std::string("/") + module->getFullModuleName() + ".modulemap";
-                std::error_code error;
-                llvm::raw_fd_ostream file(filePath, error, llvm::sys::fs::F_Text);
-                if (error) {
+                utils::OutputFile file(filePath);
+                module->print(file.stream());
+                if (std::error_code error = file.close()) {
                     std::cout << error.message();
-                    continue;
                 }
-                module->print(file);
-                file.close();
             }
         }
 
@@ -106,20 +171,77 @@ public:
         if (!cla_outputDtsFolder.empty()) {
             llvm::sys::fs::create_directories(cla_outputDtsFolder);
             std::string docSetPath = cla_docSetFile.empty() ? "" : cla_docSetFile.getValue();
-            for (std::pair<clang::Module*, std::vector<Meta::Meta*> >& modulePair : metasByModules) {
-                TypeScript::DefinitionWriter definitionWriter(modulePair, _visitor.getMetaFactory().getTypeFactory(), docSetPath);
+            TypeScript::InheritedMembers inheritedMembers((Meta::ClassHierarchy(metaContainer)));
+
+            // The modules are written concurrently, each one to its own file. The largest ones are
+            // taken first, so that the workers don't end up waiting for a single large module.
+            std::vector<std::pair<clang::Module*, std::vector<Meta::Meta*> >*> dtsModules;
+            if (!cla_typeScriptModules.empty() || !cla_typeScriptSymbols.empty()) {
+                std::vector<std::string> requestedModules(cla_typeScriptModules.begin(), cla_typeScriptModules.end());
+                std::vector<std::string> modulesOfSymbols = getModulesOfSymbols(metasByModules, cla_typeScriptSymbols);
+                requestedModules.insert(requestedModules.end(), modulesOfSymbols.begin(), modulesOfSymbols.end());
+                dtsModules = getReferencedModulesClosure(metasByModules, requestedModules, _visitor.getMetaFactory().getTypeFactory());
+            } else {
+                for (std::pair<clang::Module*, std::vector<Meta::Meta*> >& modulePair : metasByModules) {
+                    dtsModules.push_back(&modulePair);
+                }
+            }
+            std::stable_sort(dtsModules.begin(), dtsModules.end(), [](const std::pair<clang::Module*, std::vector<Meta::Meta*> >* module1, const std::pair<clang::Module*, std::vector<Meta::Meta*> >* module2) {
+                return module1->second.size() > module2->second.size();
+            });
+
+            // Everything which uses the type factory or may deserialize clang declarations is done before the workers start
+            TypeScript::DefinitionWriter::BaseTypeArguments baseTypeArguments = TypeScript::DefinitionWriter::getBaseTypeArguments(dtsModules, _visitor.getMetaFactory().getTypeFactory());
+
+            std::unique_ptr<TypeScript::CommentDatabase> commentDatabase;
+            if (!docSetPath.empty()) {
+                TypeScript::DocSetManager::initializeParser();
+                if (!cla_docSetCacheFile.empty()) {
+                    uint64_t docSetVersion;
+                    if (TypeScript::DocSetManager::getVersion(docSetPath, docSetVersion)) {
+                        commentDatabase.reset(new TypeScript::CommentDatabase(cla_docSetCacheFile, docSetVersion));
+                    } else {
+                        // The comments of an updated docset at the same path would be served from the cache otherwise
+                        std::cout << "The version of the docset can't be determined, the docset comments are not cached" << std::endl;
+                    }
+                }
+            }
 
-                llvm::SmallString<128> path;
-                llvm::sys::path::append(path, cla_outputDtsFolder, "objc!" + modulePair.first->getFullModuleName() + ".d.ts");
-                std::error_code error;
-                llvm::raw_fd_ostream file(path.str(), error, llvm::sys::fs::F_Text);
-                if (error) {
-                    std::cout << error.message();
-                    return;
+            std::vector<std::string> errors(dtsModules.size());
+            std::atomic<size_t> nextModule(0);
+            auto writeModules = [&]() {
+                for (size_t i = nextModule++; i < dtsModules.size(); i = nextModule++) {
+                    std::pair<clang::Module*, std::vector<Meta::Meta*> >& modulePair = *dtsModules[i];
+                    TypeScript::DefinitionWriter definitionWriter(modulePair, baseTypeArguments, inheritedMembers, docSetPath, commentDatabase.get());
+
+                    llvm::SmallString<128> path;
+                    llvm::sys::path::append(path, cla_outputDtsFolder, "objc!" + modulePair.first->getFullModuleName() + ".d.ts");
+                    utils::OutputFile file(path.str());
+                    definitionWriter.write(file.stream());
+                    if (std::error_code error = file.close()) {
+                        errors[i] = error.message();
+                    }
                 }
+            };
 
-                file << definitionWriter.write();
-                file.close();
+            size_t workersCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), dtsModules.size());
+            std::vector<std::future<void> > workers;
+            for (size_t i = 1; i < workersCount; i++) {
+                workers.push_back(std::async(std::launch::async, writeModules));
+            }
+            writeModules();
+            for (std::future<void>& worker : workers) {
+                worker.get();
+            }
+
+            for (const std::string& error : errors) {
+                if (!error.empty()) {
+                    std::cout << error;
+                }
+            }
+
+            if (commentDatabase && !commentDatabase->save()) {
+                std::cout << "Unable to save the docset comments to " << cla_docSetCacheFile << std::endl;
             }
         }
     }
@@ -177,6 +299,12 @@ int main(int argc, const char** argv)
         llvm::cl::ParseCommandLineOptions(argc, argv);
         assert(cla_clangArgumentsDelimiter.getValue() == "Xclang");
 
+        utils::Logger::Format logFormat;
+        if (!utils::Logger::parseFormat(cla_verboseFormat, logFormat)) {
+            throw std::runtime_error("Unknown verbose output format '" + cla_verboseFormat + "'");
+        }
+        utils::Logger::get().start(cla_verbose ? utils::LogLevel::Verbose : utils::LogLevel::Error, logFormat);
+
         // Log Metadata Genrator Arguments
         dumpArgs(std::cout, argc, argv);
         dumpArgs(std::cerr, argc, argv);
@@ -221,16 +349,12 @@ int main(int argc, const char** argv)
 
         // Save the umbrella file
         if (!cla_outputUmbrellaHeaderFile.empty()) {
-            std::error_code errorCode;
-            llvm::raw_fd_ostream umbrellaFileStream(cla_outputUmbrellaHeaderFile, errorCode, llvm::sys::fs::OpenFlags::F_None);
-            if (!errorCode) {
-                umbrellaFileStream << umbrellaContent;
-                umbrellaFileStream.close();
-            }
+            utils::OutputFile::write(cla_outputUmbrellaHeaderFile, umbrellaContent);
         }
         // generate metadata for the intermediate sdk header
         Meta::ModulesBlacklist modulesBlacklist(cla_whiteListModuleRegexesFile, cla_blackListModuleRegexesFile);
         clang::tooling::runToolOnCodeWithArgs(new MetaGenerationFrontendAction(/*r*/modulesBlacklist), umbrellaContent, clangArgs, "umbrella.h", "objc-metadata-generator");
+        utils::Logger::get().stop();
 
         std::clock_t end = clock();
         double elapsed_secs = double(end - begin) / CLOCKS_PER_SEC;
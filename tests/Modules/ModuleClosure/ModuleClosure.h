@@ -0,0 +1,9 @@
+#import <Foundation/NSObject.h>
+#import <PendingDependencies/PendingDependencies.h>
+
+@interface TNSClosureBase<ObjectType> : NSObject
+@end
+
+// PendingDependencies is referenced only by the type argument of the base class
+@interface TNSClosureDerived : TNSClosureBase<TNSPendingB*>
+@end
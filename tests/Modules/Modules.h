@@ -0,0 +1,2 @@
+#import <PendingDependencies/PendingDependencies.h>
+#import <ModuleClosure/ModuleClosure.h>
@@ -0,0 +1,17 @@
+#import <Foundation/NSObject.h>
+
+// TNSPendingA is still being created when TNSPendingB's property is created, so TNSPendingB is completed
+// with a pending dependency. Both of them have to keep their members and the category merged into TNSPendingA.
+@class TNSPendingB;
+
+@interface TNSPendingA : NSObject
+- (TNSPendingB*)b;
+@end
+
+@interface TNSPendingB : NSObject
+@property (readonly) TNSPendingA* a;
+@end
+
+@interface TNSPendingA (TNSPendingCategory)
+- (void)methodFromCategory;
+@end
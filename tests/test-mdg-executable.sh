@@ -37,7 +37,37 @@ function GenerateMetadata() {
     )
 }
 
+# Generates the YAML and TypeScript definitions of the modules in tests/Modules. Additional generator options can follow the output directory.
+function GenerateTestModules() {
+    MDG=$1
+    OUTDIR=$2
+    shift 2
+    (
+        cd $(dirname "$MDG")
+        SYSROOT=$DEVELOPER_DIR/Platforms/iPhoneSimulator.platform/Developer/SDKs/iPhoneSimulator.sdk
+
+        rm -rf $OUTDIR
+        ./$(basename $MDG) -output-yaml $OUTDIR/yaml -output-typescript $OUTDIR/typescript -input-umbrella $TESTMODULESDIR/Modules.h "$@" \
+        Xclang \
+        -isysroot $SYSROOT -arch x86_64 -mios-simulator-version-min=9.0 -std=gnu99 -I$TESTMODULESDIR > /dev/null 2>&1
+    )
+}
+
+# Fails if the TypeScript definitions generated for a closure of modules differ from the ones generated for all modules
+function ExpectSameDefinitions() {
+    test -f "$1/typescript/objc!PendingDependencies.d.ts" || (echo "error: PendingDependencies is missing from the closure in $1" 1>&2 && false)
+    for FILE in "$1"/typescript/*.d.ts; do
+        cmp -s "$FILE" "$2/typescript/$(basename "$FILE")" || (echo "error: $FILE differs from the one generated for all modules" 1>&2 && false)
+    done
+}
+
+# Fails if a generated file doesn't contain the given text
+function ExpectInFile() {
+    grep -qF "$2" "$1" || (echo "error: '$2' not found in $1" 1>&2 && false)
+}
+
 TESTSDIR=$(dirname $0)
+TESTMODULESDIR=$(cd $TESTSDIR/Modules && pwd)
 XCODEVERSION=$(/usr/bin/xcodebuild -version | grep Xcode | cut -f2 -d' ')
 EXPECTEDOUTPUTDIR="$TESTSDIR/ExpectedOutput$XCODEVERSION"
 if [ ! -d "$EXPECTEDOUTPUTDIR" ]; then
@@ -52,3 +82,17 @@ GenerateMetadata $MDG $TESTSDIR/AllSystemFrameworks.h $TESTOUTPUTDIR
 echo "Comparing test outputs..."
 (diff -qwr $EXPECTEDOUTPUTDIR $TESTOUTPUTDIR && echo "Test run successful, no differences encountered.") ||
 (echo "error: Metadata generator didn't produce the expected output. Fix or accept the new one by replacing $EXPECTEDOUTPUTDIR with $TESTOUTPUTDIR" 1>&2 && false)
+
+echo "Checking the metas completed with pending dependencies..."
+TESTMODULESOUTPUTDIR=$(cd $TESTSDIR && pwd)/TestModulesOutput
+GenerateTestModules $MDG $TESTMODULESOUTPUTDIR
+PENDINGDEPENDENCIESDTS="$TESTMODULESOUTPUTDIR/typescript/objc!PendingDependencies.d.ts"
+ExpectInFile "$PENDINGDEPENDENCIESDTS" "b(): TNSPendingB;"
+ExpectInFile "$PENDINGDEPENDENCIESDTS" "a: TNSPendingA;"
+ExpectInFile "$PENDINGDEPENDENCIESDTS" "methodFromCategory(): void;"
+
+echo "Checking the definitions generated for the closure of a module..."
+GenerateTestModules $MDG $TESTMODULESOUTPUTDIR/ClosureOfModule -typescript-modules=ModuleClosure
+ExpectSameDefinitions $TESTMODULESOUTPUTDIR/ClosureOfModule $TESTMODULESOUTPUTDIR
+GenerateTestModules $MDG $TESTMODULESOUTPUTDIR/ClosureOfSymbol -typescript-symbols=TNSClosureDerived
+ExpectSameDefinitions $TESTMODULESOUTPUTDIR/ClosureOfSymbol $TESTMODULESOUTPUTDIR